@@ -14,13 +14,27 @@ namespace cot {
 class DataDependencyGraph;
 class ControlDependencyGraph;
 class ProgramDependencyGraph;
+class DependencyLayers;
+class PostDominanceFrontier;
+class ParallelDependencyGraphs;
+class InstructionDependencyGraph;
+class ProgramSlicing;
+class LazyProgramDependencyGraph;
+class CriticalEdgeSplitting;
 
 // Analysis.
 DataDependencyGraph *CreateDataDependencyGraphPass();
 ControlDependencyGraph *CreateControlDependencyGraphPass();
 ProgramDependencyGraph *CreateProgramDependencyGraphPass();
+DependencyLayers *CreateDependencyLayersPass();
+PostDominanceFrontier *CreatePostDominanceFrontierPass();
+ParallelDependencyGraphs *CreateParallelDependencyGraphsPass();
+InstructionDependencyGraph *CreateInstructionDependencyGraphPass();
+ProgramSlicing *CreateProgramSlicingPass();
+LazyProgramDependencyGraph *CreateLazyProgramDependencyGraphPass();
 
 // Transformations.
+CriticalEdgeSplitting *CreateCriticalEdgeSplittingPass();
 
 } // End namespace cot.
 
@@ -32,7 +46,12 @@ class PassRegistry;
 void initializeDataDependencyGraphPass(PassRegistry &Registry);
 void initializeControlDependencyGraphPass(PassRegistry &Registry);
 void initializeProgramDependencyGraphPass(PassRegistry &Registry);
+void initializeDependencyLayersPass(PassRegistry &Registry);
 void initializePostDominanceFrontierPass(PassRegistry &Registry);
+void initializeParallelDependencyGraphsPass(PassRegistry &Registry);
+void initializeInstructionDependencyGraphPass(PassRegistry &Registry);
+void initializeProgramSlicingPass(PassRegistry &Registry);
+void initializeLazyProgramDependencyGraphPass(PassRegistry &Registry);
 
 // Dot viewer passes
 void initializeDataDependencyViewerPass(PassRegistry &Registry);
@@ -43,7 +62,19 @@ void initializeProgramDependencyViewerPass(PassRegistry &Registry);
 void initializeDataDependencyPrinterPass(PassRegistry &Registry);
 void initializeControlDependencyPrinterPass(PassRegistry &Registry);
 void initializeProgramDependencyPrinterPass(PassRegistry &Registry);
+
+// Streaming exporter passes
+void initializeDataDependencyExporterPass(PassRegistry &Registry);
+void initializeControlDependencyExporterPass(PassRegistry &Registry);
+void initializeProgramDependencyExporterPass(PassRegistry &Registry);
+
+// Query printer passes
+void initializeReachabilityPrinterPass(PassRegistry &Registry);
+void initializeComponentsPrinterPass(PassRegistry &Registry);
+void initializeQueriesPrinterPass(PassRegistry &Registry);
+
 // Transformations.
+void initializeCriticalEdgeSplittingPass(PassRegistry &Registry);
 
 } // End namespace llvm.
 
@@ -26,28 +26,61 @@
 #include "llvm/ADT/DepthFirstIterator.h"
 #include "llvm/Support/raw_ostream.h"
 
+namespace llvm
+{
+  class Function;
+  class TerminatorInst;
+  template <class NodeT> class DominatorTreeBase;
+}
+
 namespace cot
 {
   typedef DependencyGraph<llvm::BasicBlock> ControlDepGraph;
 
   /*!
-   * Control Dependency Graph
+   * Kinds of the control links induced by the edge to successor Succ of TI:
+   * conditional branches label them as taken on true or on false, switches
+   * as taken on a case.
+   */
+  unsigned getEdgeKinds(const llvm::TerminatorInst *TI, unsigned Succ);
+
+  /*!
+   * Add the control links of F, given its post-dominator tree, to CDG, a
+   * graph in its construction phase. With more than one thread, large
+   * functions have their CFG edges processed in parallel.
+   */
+  void addControlDependencies(llvm::Function &F,
+                              llvm::DominatorTreeBase<llvm::BasicBlock> &PDT,
+                              ControlDepGraph &CDG,
+                              unsigned NumThreads = 1);
+
+  /*!
+   * Add to CDG the control links from BB, a block of F, or from the entry
+   * node if BB is null: those induced by the CFG edges leaving it.
+   */
+  void addBlockControlDependencies(
+      llvm::Function &F, llvm::BasicBlock *BB,
+      llvm::DominatorTreeBase<llvm::BasicBlock> &PDT, ControlDepGraph &CDG);
+
+  /*!
+   * Build the control dependency graph of F, given its post-dominator tree.
+   */
+  void buildControlDependencies(llvm::Function &F,
+                                llvm::DominatorTreeBase<llvm::BasicBlock> &PDT,
+                                ControlDepGraph &CDG,
+                                unsigned NumThreads = 1);
+
+  /*!
+   * Control Dependency Graph, the control layer of the graph shared through
+   * DependencyLayers.
    */
   class ControlDependencyGraph : public llvm::FunctionPass
   {
   public:
     static char ID; // Pass ID, replacement for typeid
-    ControlDepGraph *CDG;
+    DepGraphView CDG;
 
-    ControlDependencyGraph() : llvm::FunctionPass(ID)
-    {
-      CDG = new ControlDepGraph();
-    }
-
-    ~ControlDependencyGraph()
-    {
-      delete CDG;
-    }
+    ControlDependencyGraph() : llvm::FunctionPass(ID) { }
 
     bool runOnFunction(llvm::Function &F);
 
@@ -66,17 +99,17 @@ namespace llvm
 {
 
   template <> struct GraphTraits<cot::ControlDependencyGraph *>
-      : public GraphTraits<cot::DepGraph*> {
+      : public cot::DependencyViewGraphTraits<cot::ControlTypeMask> {
     static NodeType *getEntryNode(cot::ControlDependencyGraph *CG) {
-      return *(CG->CDG->begin_children());
+      return *(CG->CDG.begin_children());
     }
 
     static nodes_iterator nodes_begin(cot::ControlDependencyGraph *CG) {
-      return CG->CDG->begin_children();
+      return CG->CDG.begin_children();
     }
 
     static nodes_iterator nodes_end(cot::ControlDependencyGraph *CG) {
-      return CG->CDG->end_children();
+      return CG->CDG.end_children();
     }
   };
 
@@ -0,0 +1,56 @@
+/** ---*- C++ -*--- CriticalEdgeSplitting.h
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+
+
+#ifndef CRITICALEDGESPLITTING_H
+#define CRITICALEDGESPLITTING_H
+
+#include "llvm/Pass.h"
+
+namespace llvm
+{
+  class Function;
+}
+
+namespace cot
+{
+  /*!
+   * Split the critical edges of a function, as -break-crit-edges does, while
+   * preserving its dependency graphs: the post-dominator tree and the shared
+   * graph are updated for the new blocks instead of being built again.
+   */
+  class CriticalEdgeSplitting : public llvm::FunctionPass
+  {
+  public:
+    static char ID; // Pass ID, replacement for typeid
+
+    CriticalEdgeSplitting() : llvm::FunctionPass(ID) { }
+
+    bool runOnFunction(llvm::Function &F);
+
+    void getAnalysisUsage(llvm::AnalysisUsage &AU) const;
+
+    const char *getPassName() const
+    {
+      return "Critical Edge Splitting";
+    }
+  };
+}
+
+#endif // CRITICALEDGESPLITTING_H
@@ -23,29 +23,145 @@
 
 #include "llvm/Pass.h"
 #include "cot/DependencyGraph/DependencyGraph.h"
+#include "llvm/ADT/DenseMap.h"
+
+#include <vector>
+
+namespace llvm
+{
+  class AliasAnalysis;
+  class BasicBlock;
+  class Function;
+  class Instruction;
+  class MemoryDependenceAnalysis;
+}
 
 namespace cot
 {
   typedef DependencyGraph<llvm::BasicBlock> DataDepGraph;
 
   /*!
-   * Data Dependency Graph
+   * Memory dependences of a function, as found by MemoryDependenceAnalysis
+   * or by alias set partitioning.
+   * Queries are not thread-safe, so they are issued up front and kept apart
+   * from the graph, which can then be built on any thread.
+   */
+  struct MemoryDependences
+  {
+    typedef std::pair<const llvm::Instruction *, const llvm::Instruction *>
+      Link;
+
+    explicit MemoryDependences(unsigned LinkBudget = 0) :
+    Budget(LinkBudget) { }
+
+    /*!
+     * Most blocks the memory dependences of a block may lie in, 0 if there
+     * is no limit. The links of a block over it are summarized as they are
+     * collected: they only show in ToMemoryState and FromMemoryState.
+     */
+    unsigned Budget;
+
+    /// (dependent, dependency) instruction pairs.
+    std::vector<Link> Links;
+
+    /*!
+     * Kinds of the summarized links, from each block they come from to the
+     * memory state node, and from that node to each summarized block.
+     */
+    llvm::DenseMap<const llvm::BasicBlock *, unsigned> ToMemoryState;
+    llvm::DenseMap<const llvm::BasicBlock *, unsigned> FromMemoryState;
+
+    void clear()
+    {
+      Links.clear();
+      ToMemoryState.clear();
+      FromMemoryState.clear();
+    }
+  };
+
+  /*!
+   * Collect the memory dependences of F. By default MDA is queried for
+   * every store; stores whose dependences lie outside their block are
+   * resolved through the non-local pointer query, so only blocks that
+   * define or clobber the location are recorded. When MDA cannot tell on
+   * some path, the store depends on every access of F. With -ddg-alias-sets
+   * the accesses are paired by collectAliasSetDependences instead. Either
+   * way, the links of a block go to the summary as soon as they exceed the
+   * budget of Deps.
+   */
+  void collectMemoryDependences(llvm::Function &F, llvm::AliasAnalysis &AA,
+                                llvm::MemoryDependenceAnalysis &MDA,
+                                MemoryDependences &Deps);
+
+  /*!
+   * Append the memory dependences of the stores of BB to Deps, querying MDA
+   * as collectMemoryDependences does by default.
+   */
+  void collectBlockStoreDependences(llvm::BasicBlock &BB,
+                                    llvm::AliasAnalysis &AA,
+                                    llvm::MemoryDependenceAnalysis &MDA,
+                                    MemoryDependences &Deps);
+
+  /*!
+   * Group the memory accesses of F by alias set and link the accesses of a
+   * common set when at least one of them may write it. Like the MDA queries,
+   * this honours the budget of Deps. This finds RAW, WAR
+   * and WAW dependences of loads, stores and calls in O(n * s), s being the
+   * size of an alias set. An access whose set cannot be found from its
+   * pointers, as a call that may touch any memory, is linked with every
+   * access instead.
+   */
+  void collectAliasSetDependences(llvm::Function &F, llvm::AliasAnalysis &AA,
+                                  MemoryDependences &Deps);
+
+  /// Whether collectMemoryDependences partitions accesses by alias set.
+  bool usesAliasSetDependences();
+
+  /*!
+   * Most blocks whose memory dependences a block may link from before they
+   * are summarized (-ddg-memory-link-budget), 0 if there is no limit. Block
+   * graphs collect their memory dependences under this budget; instruction
+   * graphs need every link.
+   */
+  unsigned getMemoryLinkBudget();
+
+  /*!
+   * Kinds of the memory dependence of I on Dep, given what each of them may
+   * do to memory: the memory kind, along with flow, anti and output for each
+   * order of a read and a write, or of two writes, they may be in.
+   */
+  unsigned getMemoryDependenceKinds(const llvm::Instruction *I,
+                                    const llvm::Instruction *Dep);
+
+  /*!
+   * Add the data links of F, given its memory dependences, to DDG, a graph
+   * in its construction phase. Links between temporaries are flow
+   * dependences; memory links have the kinds given by
+   * getMemoryDependenceKinds(). A block whose memory dependences lie in more
+   * blocks than the budget of Deps gets them through the memory state node:
+   * each of these blocks links to it, and it links to the block.
+   * Reachability is kept, at the price of spurious paths between the
+   * summarized blocks, while the memory links stay linear in the number of
+   * blocks.
+   */
+  void addDataDependencies(llvm::Function &F, const MemoryDependences &Deps,
+                           DataDepGraph &DDG);
+
+  /// Build the data dependency graph of F, given its memory dependences.
+  void buildDataDependencies(llvm::Function &F, const MemoryDependences &Deps,
+                             DataDepGraph &DDG);
+
+  /*!
+   * Data Dependency Graph, the data layer of the graph shared through
+   * DependencyLayers.
    */
   class DataDependencyGraph : public llvm::FunctionPass
   {
   public:
     static char ID; // Pass ID, replacement for typeid
-    DataDepGraph *DDG;
+    DepGraphView DDG;
 
-    DataDependencyGraph() : FunctionPass(ID)
-    {
-      DDG = new DataDepGraph();
-    }
-
-    ~DataDependencyGraph()
-    {
-      delete DDG;
-    }
+    DataDependencyGraph() : FunctionPass(ID) { }
 
     virtual bool runOnFunction(llvm::Function &F);
 
@@ -64,17 +180,17 @@ namespace llvm
 {
 
   template <> struct GraphTraits<cot::DataDependencyGraph *>
-      : public GraphTraits<cot::DepGraph*> {
+      : public cot::DependencyViewGraphTraits<cot::DataTypeMask> {
     static NodeType *getEntryNode(cot::DataDependencyGraph *DG) {
-      return *(DG->DDG->begin_children());
+      return *(DG->DDG.begin_children());
     }
 
     static nodes_iterator nodes_begin(cot::DataDependencyGraph *DG) {
-      return DG->DDG->begin_children();
+      return DG->DDG.begin_children();
     }
 
     static nodes_iterator nodes_end(cot::DataDependencyGraph *DG) {
-      return DG->DDG->end_children();
+      return DG->DDG.end_children();
     }
   };
 
@@ -0,0 +1,92 @@
+/** ---*- C++ -*--- DependencyArena.h
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef DEPENDENCYARENA_H
+#define DEPENDENCYARENA_H
+
+#include "llvm/Support/Allocator.h"
+
+namespace cot
+{
+
+  /*!
+   * Slab allocator that never gives memory back to the system until it is
+   * destroyed: released slabs are kept in a free list and handed out again.
+   */
+  class RecyclingSlabAllocator : public llvm::SlabAllocator
+  {
+  public:
+    RecyclingSlabAllocator() : mFreeSlabs(0), mBytes(0) { }
+
+    virtual ~RecyclingSlabAllocator();
+
+    virtual llvm::MemSlab *Allocate(size_t Size);
+
+    virtual void Deallocate(llvm::MemSlab *Slab);
+
+    /// Bytes obtained from the system, whether in use or not.
+    size_t getTotalMemory() const { return mBytes; }
+
+  private:
+    llvm::MemSlab *mFreeSlabs;
+    size_t mBytes;
+  };
+
+  /*!
+   * Bump pointer arena holding the nodes and the links of a dependency graph.
+   * Resetting it frees every object at once, but keeps the slabs, so a pass
+   * running on many functions reuses the same memory over and over.
+   */
+  class DependencyArena
+  {
+  public:
+    static const size_t SlabSize = 64 * 1024;
+
+    DependencyArena() : mAllocator(SlabSize, SlabSize, mSlabs) { }
+
+    void *Allocate(size_t Size, size_t Alignment)
+    {
+      return mAllocator.Allocate(Size, Alignment);
+    }
+
+    template <typename T>
+    T *Allocate(size_t Num)
+    {
+      return mAllocator.Allocate<T>(Num);
+    }
+
+    void reset()
+    {
+      mAllocator.Reset();
+    }
+
+    size_t getTotalMemory() const { return mSlabs.getTotalMemory(); }
+
+  private:
+    DependencyArena(const DependencyArena &);
+    void operator=(const DependencyArena &);
+
+    // Must be declared before mAllocator, which gives its slabs back when
+    // destroyed.
+    RecyclingSlabAllocator mSlabs;
+    llvm::BumpPtrAllocator mAllocator;
+  };
+
+}
+
+#endif // DEPENDENCYARENA_H
@@ -0,0 +1,81 @@
+/** ---*- C++ -*--- DependencyCache.h
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef DEPENDENCYCACHE_H
+#define DEPENDENCYCACHE_H
+
+#include "cot/DependencyGraph/DependencyGraph.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/DataTypes.h"
+
+namespace llvm
+{
+  class Function;
+}
+
+namespace cot
+{
+  /*!
+   * On-disk cache of block-level dependency graphs, enabled by giving its
+   * directory with -dg-cache-dir.
+   *
+   * Each graph is stored in its own file, named after the hash of the
+   * function and the kind of graph ("cdg", "ddg" or "pdg", after the layers
+   * it holds). The file holds the frozen CSR arrays of the graph as they are
+   * in memory, so that loading it maps the file and points the graph into
+   * it, without copying links.
+   *
+   * The hash covers the printed IR of the function, the memory dependence
+   * engine in use and -dg-cache-salt. Facts outside the function that alias
+   * analyses may use, such as the attributes of callees, are not covered:
+   * runs with different module contexts or alias analyses should use
+   * different salts or directories.
+   */
+
+  /// Whether -dg-cache-dir was given.
+  bool isGraphCacheEnabled();
+
+  /// Key of the graphs of F in the cache.
+  uint64_t hashFunctionIR(const llvm::Function &F);
+
+  /*!
+   * Whether a file holds the graph of kind Kind of the function with the
+   * given hash, without reading it. A graph reported missing counts as a
+   * cache miss.
+   */
+  bool hasCachedGraph(uint64_t Hash, llvm::StringRef Kind);
+
+  /*!
+   * Load the graph of kind Kind of F, given its hash, into G. Return false
+   * and leave G untouched if the graph is not cached or its file does not
+   * look sane.
+   */
+  bool loadCachedGraph(const llvm::Function &F, uint64_t Hash,
+                       llvm::StringRef Kind, DependencyGraph<llvm::BasicBlock> &G);
+
+  /*!
+   * Store G, the graph of kind Kind of F, in the cache. The file is written
+   * aside and renamed, so concurrent runs never see it half written.
+   * Failures are ignored: the graph is then built again next time.
+   */
+  void storeCachedGraph(const llvm::Function &F, uint64_t Hash,
+                        llvm::StringRef Kind,
+                        const DependencyGraph<llvm::BasicBlock> &G);
+}
+
+#endif // DEPENDENCYCACHE_H
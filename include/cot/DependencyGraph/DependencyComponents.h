@@ -0,0 +1,134 @@
+/** ---*- C++ -*--- DependencyComponents.h
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef DEPENDENCYCOMPONENTS_H
+#define DEPENDENCYCOMPONENTS_H
+
+#include "llvm/Support/DataTypes.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace cot
+{
+
+  /*!
+   * Strongly connected components of a frozen dependency graph, together with
+   * the DAG they condense it to and the topological level of each of them.
+   *
+   * Components are numbered in reverse topological order: links of the
+   * condensed DAG always go from a component to a lower numbered one, so
+   * walking the numbers downwards visits the DAG in topological order. The
+   * level of a component is the length of the longest DAG path reaching it;
+   * components of the same level do not depend on each other.
+   */
+  class DependencyComponents
+  {
+  public:
+    DependencyComponents() : mNumComponents(0), mNumLevels(0) { }
+
+    /*!
+     * Compute the components of the graph whose links are in CSR form: the
+     * targets of node ID are in [Targets[Begin[ID]], Targets[Begin[ID + 1]]).
+     * The decomposition is iterative, so it works on graphs of any depth.
+     */
+    void compute(uint32_t NumNodes, const uint32_t *Begin,
+                 const uint32_t *Targets);
+
+    unsigned getNumComponents() const { return mNumComponents; }
+
+    /// Component of node ID.
+    uint32_t getComponent(uint32_t ID) const { return mComponent[ID]; }
+
+    /// Node IDs of component C, in increasing order.
+    const uint32_t *members_begin(uint32_t C) const
+    {
+      return data(mMembers) + mMemberBegin[C];
+    }
+
+    const uint32_t *members_end(uint32_t C) const
+    {
+      return data(mMembers) + mMemberBegin[C + 1];
+    }
+
+    /// Whether C holds a dependence cycle.
+    bool isCyclic(uint32_t C) const
+    {
+      return mMemberBegin[C + 1] - mMemberBegin[C] > 1;
+    }
+
+    /// Components C has a link to in the condensed DAG.
+    const uint32_t *dag_begin(uint32_t C) const
+    {
+      return data(mDagTargets) + mDagBegin[C];
+    }
+
+    const uint32_t *dag_end(uint32_t C) const
+    {
+      return data(mDagTargets) + mDagBegin[C + 1];
+    }
+
+    unsigned getNumLevels() const { return mNumLevels; }
+
+    uint32_t getLevel(uint32_t C) const { return mLevel[C]; }
+
+    /// Components of level L, in decreasing number.
+    const uint32_t *level_begin(uint32_t L) const
+    {
+      return data(mByLevel) + mLevelBegin[L];
+    }
+
+    const uint32_t *level_end(uint32_t L) const
+    {
+      return data(mByLevel) + mLevelBegin[L + 1];
+    }
+
+    /// Bytes used by the decomposition.
+    size_t getMemoryUsage() const;
+
+  private:
+    static const uint32_t *data(const std::vector<uint32_t> &V)
+    {
+      return V.empty() ? 0 : &V[0];
+    }
+
+    void computeComponents(uint32_t NumNodes, const uint32_t *Begin,
+                           const uint32_t *Targets);
+    void buildCondensation(uint32_t NumNodes, const uint32_t *Begin,
+                           const uint32_t *Targets);
+    void computeLevels();
+
+    uint32_t mNumComponents;
+    std::vector<uint32_t> mComponent;
+    std::vector<uint32_t> mMemberBegin;
+    std::vector<uint32_t> mMembers;
+
+    // Condensed DAG, in CSR form.
+    std::vector<uint32_t> mDagBegin;
+    std::vector<uint32_t> mDagTargets;
+
+    // Topological levels.
+    uint32_t mNumLevels;
+    std::vector<uint32_t> mLevel;
+    std::vector<uint32_t> mLevelBegin;
+    std::vector<uint32_t> mByLevel;
+  };
+
+}
+
+#endif // DEPENDENCYCOMPONENTS_H
@@ -19,16 +19,30 @@
 #ifndef DEPENDENCYGRAPH_H_
 #define DEPENDENCYGRAPH_H_
 
+#include "cot/DependencyGraph/DependencyArena.h"
+#include "cot/DependencyGraph/DependencyComponents.h"
 #include "llvm/BasicBlock.h"
 #include "llvm/Assembly/Writer.h"
+#include "llvm/ADT/DenseMap.h"
 #include "llvm/ADT/GraphTraits.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/Support/AlignOf.h"
+#include "llvm/Support/DataTypes.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/raw_ostream.h"
 
 
+#include <algorithm>
+#include <cassert>
 #include <iterator>
-#include <map>
+#include <new>
 #include <vector>
 
+namespace llvm
+{
+  class Instruction;
+}
+
 namespace cot
 {
 
@@ -38,110 +52,254 @@ namespace cot
     DATA
   };
 
-  template <class NodeT> class DependencyLinkIterator;
+  static const unsigned NumDependencyTypes = DATA + 1;
 
-  template <class NodeT = llvm::BasicBlock>
-  class DependencyNode
+  /*!
+   * Reasons for a link, refining its type. A data link is a flow (read after
+   * write), anti (write after read) or output (write after write) dependence,
+   * through memory if it has the memory kind; a memory link without the
+   * others only means that the two accesses may conflict. A control link may
+   * carry the label of the branch edges inducing it.
+   */
+  enum DependencyKind
   {
-  public:
-    typedef std::pair<DependencyNode<NodeT> *, DependencyType> DependencyLink;
-    typedef std::vector<DependencyLink> DependencyLinkList;
-    typedef DependencyLinkIterator<NodeT> iterator;
-    typedef DependencyLinkIterator<NodeT> const_iterator;
+    FLOW_DEPENDENCE,
+    ANTI_DEPENDENCE,
+    OUTPUT_DEPENDENCE,
+    MEMORY_DEPENDENCE,
+    CONTROL_DEPENDENCE,
+    TRUE_BRANCH,
+    FALSE_BRANCH,
+    CASE_BRANCH
+  };
 
-    iterator begin()
+  static const unsigned NumDependencyKinds = CASE_BRANCH + 1;
+
+  /*!
+   * Masks of dependency kinds, kind K standing for bit 1 << K. A link of a
+   * frozen graph carries the mask of all its kinds in a byte, and the mask
+   * of a type holds every kind of that type.
+   */
+  static const unsigned DataTypeMask = (1U << CONTROL_DEPENDENCE) - 1;
+  static const unsigned ControlTypeMask = (1U << NumDependencyKinds) - 1 -
+                                          DataTypeMask;
+  static const unsigned AllTypesMask = DataTypeMask | ControlTypeMask;
+  static const unsigned BranchKindMask = ControlTypeMask -
+                                         (1U << CONTROL_DEPENDENCE);
+
+  /// Mask of the kinds of Type.
+  inline unsigned getDependencyTypeMask(DependencyType Type)
+  {
+    return Type == CONTROL ? ControlTypeMask : DataTypeMask;
+  }
+
+  /// Kind of the links added with a type only.
+  inline DependencyKind getDefaultKind(DependencyType Type)
+  {
+    return Type == CONTROL ? CONTROL_DEPENDENCE : FLOW_DEPENDENCE;
+  }
+
+  /// Name of Kind, as used by exporters.
+  inline const char *getDependencyKindName(DependencyKind Kind)
+  {
+    switch (Kind)
     {
-      return DependencyLinkIterator<NodeT>(mDependencies.begin());
+    case FLOW_DEPENDENCE:
+      return "flow";
+    case ANTI_DEPENDENCE:
+      return "anti";
+    case OUTPUT_DEPENDENCE:
+      return "output";
+    case MEMORY_DEPENDENCE:
+      return "memory";
+    case CONTROL_DEPENDENCE:
+      return "control";
+    case TRUE_BRANCH:
+      return "true";
+    case FALSE_BRANCH:
+      return "false";
+    case CASE_BRANCH:
+      return "case";
     }
+    return "";
+  }
+
+  /*!
+   * Data of the memory state node, a synthetic node summarizing memory
+   * links: a link to it stands for a link to each node it links to. Like the
+   * null data of the entry node, it stands for no value and is never
+   * dereferenced.
+   */
+  template <class NodeT>
+  inline const NodeT *getMemoryStateData()
+  {
+    static const uint64_t Token = 0;
+    return reinterpret_cast<const NodeT *>(&Token);
+  }
 
-    iterator end()
+  /*!
+   * Kinds of the links between pairs of nodes, used to reject duplicated
+   * links in constant time while a graph is built. As long as the graph is
+   * small the set is a byte matrix indexed by node IDs; past MatrixMaxNodes
+   * nodes it switches to a hash map of packed node pairs.
+   */
+  class DependencyLinkSet
+  {
+  public:
+    static const unsigned MatrixMaxNodes = 1024;
+
+    DependencyLinkSet() : mDim(0), mUseMatrix(true) { }
+
+    void clear()
     {
-      return DependencyLinkIterator<NodeT>(mDependencies.end());
+      mDim = 0;
+      mUseMatrix = true;
+      mMatrix.clear();
+      mHash.clear();
     }
 
-    const_iterator begin() const
+    /// Whether the set has to be rebuilt to hold links among NumNodes nodes.
+    bool needsGrow(unsigned NumNodes) const
     {
-      return DependencyLinkIterator<NodeT>(mDependencies.begin());
+      return mUseMatrix && NumNodes > mDim;
     }
 
-    const_iterator end() const
+    /// Drop every link and resize the set for NumNodes nodes.
+    void reset(unsigned NumNodes)
     {
-      return DependencyLinkIterator<NodeT>(mDependencies.end());
+      mMatrix.clear();
+      mHash.clear();
+      mUseMatrix = NumNodes <= MatrixMaxNodes;
+      if (!mUseMatrix)
+        return;
+
+      mDim = 64;
+      while (mDim < NumNodes)
+        mDim *= 2;
+      mMatrix.resize(mDim * mDim);
     }
 
-    DependencyNode(const NodeT* pData) :
-    mpData(pData) { }
+    /*!
+     * Insert the kinds in KindMask for the link from From to To, returning
+     * those that were not there yet.
+     */
+    unsigned insert(uint32_t From, uint32_t To, unsigned KindMask)
+    {
+      uint8_t &Kinds = mUseMatrix ? mMatrix[From * mDim + To]
+                                  : mHash[(uint64_t(From) << 32) | To];
+      unsigned New = KindMask & ~unsigned(Kinds);
+      Kinds |= New;
+      return New;
+    }
 
-    void addDependencyTo(DependencyNode<NodeT>* pNode, DependencyType type)
+    /// Remove the kinds in KindMask for the link from From to To.
+    void remove(uint32_t From, uint32_t To, unsigned KindMask)
     {
-      // Avoid self-loops.
-      if (pNode == this)
-         return;
-      DependencyLink link = DependencyLink(pNode, type);
-      // Avoid double links.
-      if (std::find(mDependencies.begin(), mDependencies.end(), link)
-          == mDependencies.end())
-      mDependencies.push_back(link);
+      if (mUseMatrix)
+      {
+        mMatrix[From * mDim + To] &= ~KindMask;
+        return;
+      }
+      llvm::DenseMap<uint64_t, uint8_t>::iterator I =
+        mHash.find((uint64_t(From) << 32) | To);
+      if (I != mHash.end())
+        I->second &= ~KindMask;
     }
 
+  private:
+    unsigned mDim;
+    bool mUseMatrix;
+    std::vector<uint8_t> mMatrix;
+    llvm::DenseMap<uint64_t, uint8_t> mHash;
+  };
+
+  template <class NodeT> class DependencyGraph;
+  template <class NodeT> class DependencyLinkIterator;
+
+  /*!
+   * A node of a frozen DependencyGraph. Nodes live contiguously inside the
+   * graph, indexed by their dense ID, while their outgoing links are stored in
+   * the graph compressed-sparse-row edge arrays.
+   */
+  template <class NodeT = llvm::BasicBlock>
+  class DependencyNode
+  {
+  public:
+    typedef DependencyLinkIterator<NodeT> iterator;
+    typedef DependencyLinkIterator<NodeT> const_iterator;
+    typedef DependencyLinkIterator<NodeT> source_iterator;
+
+    DependencyNode(const DependencyGraph<NodeT> *pGraph, const NodeT *pData,
+                   uint32_t ID) :
+    mpGraph(pGraph), mpData(pData), mID(ID) { }
+
+    iterator begin() const;
+
+    iterator end() const;
+
+    /// Nodes with a link to this one, in increasing ID order.
+    source_iterator source_begin() const;
+
+    source_iterator source_end() const;
+
     const NodeT *getData() const { return mpData; }
 
-    bool dependsFrom(const DependencyNode<NodeT>* pNode) const {
-      for(typename DependencyLinkList::const_iterator it = mDependencies.begin();
-          it != mDependencies.end();
-          ++it)
-          if (it->first == pNode)
-            return true;
-      return false;
+    uint32_t getID() const { return mID; }
+
+    /// Whether this is the entry or the memory state node, with no value.
+    bool isSynthetic() const
+    {
+      return !mpData || mpData == getMemoryStateData<NodeT>();
     }
+
+    bool dependsFrom(const DependencyNode<NodeT>* pNode) const;
+
   private:
+    const DependencyGraph<NodeT> *mpGraph;
     const NodeT* mpData;
-    DependencyLinkList mDependencies;
+    uint32_t mID;
   };
 
   typedef DependencyNode<llvm::BasicBlock> DepGraphNode;
 
   template <class NodeT = llvm::BasicBlock>
   class DependencyLinkIterator
-      : public std::iterator<std::input_iterator_tag, NodeT>
+      : public std::iterator<std::input_iterator_tag, DependencyNode<NodeT> >
   {
-    typedef typename DependencyNode<NodeT>::DependencyLinkList::const_iterator
-                     InnerIterator;
   public:
-    DependencyLinkIterator() : itr() {}
+    DependencyLinkIterator() : mpTarget(0), mpType(0), mpNodes(0) {}
 
-    DependencyLinkIterator(const InnerIterator &r)
-        : itr(r) {}
+    DependencyLinkIterator(const uint32_t *pTarget, const uint8_t *pType,
+                           DependencyNode<NodeT> *pNodes)
+        : mpTarget(pTarget), mpType(pType), mpNodes(pNodes) {}
 
     DependencyLinkIterator<NodeT> &operator++()
     {
-      ++itr;
+      ++mpTarget;
+      ++mpType;
       return *this;
     }
 
     DependencyLinkIterator<NodeT> operator++(int)
     {
       DependencyLinkIterator<NodeT> old = *this;
-      ++itr;
+      ++*this;
       return old;
     }
 
-
-    DependencyNode<NodeT> *operator->()
+    DependencyNode<NodeT> *operator->() const
     {
-      typename DependencyNode<NodeT>::DependencyLink L = *itr;
-      return L.first;
+      return mpNodes + *mpTarget;
     }
 
-    DependencyNode<NodeT> *operator*()
+    DependencyNode<NodeT> *operator*() const
     {
-      typename DependencyNode<NodeT>::DependencyLink L = *itr;
-      return L.first;
+      return mpNodes + *mpTarget;
     }
 
     bool operator!=(const DependencyLinkIterator &r) const
     {
-      return itr != r.itr;
+      return mpTarget != r.mpTarget;
     }
 
     bool operator==(const DependencyLinkIterator &r) const
@@ -149,85 +307,496 @@ namespace cot
       return !(operator!=(r));
     }
 
-    DependencyType getDependencyType() const
+    /// Kinds of the link, as a mask of 1 << Kind bits.
+    unsigned getTypeMask() const
     {
-      typename DependencyNode<NodeT>::DependencyLink L = *itr;
-      return L.second;
+      return *mpType;
+    }
+
+    bool hasType(DependencyType Type) const
+    {
+      return *mpType & getDependencyTypeMask(Type);
+    }
+
+    bool hasKind(DependencyKind Kind) const
+    {
+      return *mpType & (1U << Kind);
     }
 
   private:
-    InnerIterator itr;
+    const uint32_t *mpTarget;
+    const uint8_t *mpType;
+    DependencyNode<NodeT> *mpNodes;
   };
 
   /////////////////////////////////////////////////////////////////////////////
 
+  /*!
+   * Dependency graph. The graph has two phases: while it is being built, nodes
+   * and links are recorded through addNode()/addDependency(), or removed
+   * through removeNode()/removeDependencies(); freeze() then assigns dense
+   * node IDs and packs every link in a compressed-sparse-row layout (one
+   * offset array, one target array and one kind array). Links added between
+   * the same two nodes with different kinds are stored once, as a 32-bit
+   * target ID and a byte holding the mask of their kinds, so that a link
+   * between blocks both data and control dependent takes five bytes. The
+   * same layout indexed by target gives the reverse links. Queries,
+   * iteration and printing work on the frozen form only; thaw() goes back to
+   * the construction phase to change it.
+   *
+   * Pending links, the node table and the CSR arrays are allocated in a
+   * DependencyArena, released all at once by clear(). The arena keeps its
+   * memory, so clearing and rebuilding the graph for each function of a module
+   * does not hit the system allocator once the largest function has been seen.
+   */
   template <class NodeT = llvm::BasicBlock>
   class DependencyGraph
   {
   public:
-    typedef typename std::vector<DependencyNode<NodeT>* >::iterator nodes_iterator;
-    typedef typename std::vector<DependencyNode<NodeT>* >::const_iterator const_nodes_iterator;
+    typedef DependencyNode<NodeT> **nodes_iterator;
+    typedef DependencyNode<NodeT> *const *const_nodes_iterator;
 
-    DependencyNode<NodeT>* getRootNode() const { return RootNode; }
+    DependencyGraph() :
+    mFrozen(false), mNumPendingLinks(0), mNumErased(0), mNodes(0),
+    mNodePtrs(0), mEdgeBegin(0), mEdgeTargets(0), mEdgeTypes(0), mPredBegin(0),
+    mPredSources(0), mPredTypes(0), mNumNodes(0), mNumEdges(0),
+    mHasComponents(false) { }
 
-    DependencyNode<NodeT>* getNodeByData(const NodeT* pData)
+    /// Hint the number of nodes the graph is going to have.
+    void reserve(unsigned NumNodes)
+    {
+      mBuildNodes.reserve(NumNodes);
+      if (mLinkSet.needsGrow(NumNodes))
+        rebuildLinkSet(NumNodes);
+    }
+
+    /// Make sure a node exists for pData.
+    void addNode(const NodeT* pData)
+    {
+      getBuildID(pData);
+    }
+
+    void addDependency(const NodeT* pDependent, const NodeT* pDepency,
+            DependencyType type)
+    {
+      uint32_t From = getBuildID(pDependent);
+      uint32_t To = getBuildID(pDepency);
+      // Avoid self-loops.
+      if (From == To)
+        return;
+      // Avoid double links.
+      if (unsigned New = mLinkSet.insert(From, To, 1U << getDefaultKind(type)))
+        appendLink(From, To, New);
+    }
+
+    /// Add a link of each kind in TypeMask, as a mask of 1 << Kind bits.
+    void addDependencyTypes(const NodeT* pDependent, const NodeT* pDepency,
+                            unsigned TypeMask)
+    {
+      uint32_t From = getBuildID(pDependent);
+      uint32_t To = getBuildID(pDepency);
+      if (From == To)
+        return;
+      if (unsigned New = mLinkSet.insert(From, To, TypeMask))
+        appendLink(From, To, New);
+    }
+
+    /*!
+     * Add a link of the kinds in TypeMask from pDependent to each node in
+     * [I, E), an iterator range over node data as for freeze(). Links are
+     * appended without looking for duplicates, which are removed once by
+     * freeze(). This is the cheapest way to add many links from the same node.
+     */
+    template <class IterT>
+    void addDependencies(const NodeT* pDependent, IterT I, IterT E,
+                         unsigned TypeMask)
     {
-      typename DataToNodeMap::iterator it = mDataToNode.find(pData);
-      if (it == mDataToNode.end())
+      uint32_t From = getBuildID(pDependent);
+      for (; I != E; ++I)
       {
-        it = mDataToNode.insert(it, typename DataToNodeMap::value_type(pData,
-                new DependencyNode<NodeT > (pData)));
-        mNodes.push_back(it->second);
-        if (!RootNode)
+        uint32_t To = getBuildID(&*I);
+        if (To != From)
+          appendLink(From, To, TypeMask);
+      }
+    }
+
+    /// Remove the kinds in TypeMask from the links from pDependent.
+    void removeDependencies(const NodeT* pDependent, unsigned TypeMask)
+    {
+      uint32_t From = getBuildID(pDependent);
+      for (PendingChunk *C = mBuildNodes[From].First; C; C = C->Next)
+        for (uint32_t L = 0; L != C->Size; ++L)
+          if (C->Links[L].Types & TypeMask)
+          {
+            C->Links[L].Types &= ~TypeMask;
+            mLinkSet.remove(From, C->Links[L].Target, TypeMask);
+          }
+    }
+
+    /// Remove the kinds in TypeMask from the link from pDependent to pDepency.
+    void removeDependencyTypes(const NodeT* pDependent, const NodeT* pDepency,
+                               unsigned TypeMask)
+    {
+      uint32_t From = getBuildID(pDependent);
+      uint32_t To = getBuildID(pDepency);
+      for (PendingChunk *C = mBuildNodes[From].First; C; C = C->Next)
+        for (uint32_t L = 0; L != C->Size; ++L)
+          if (C->Links[L].Target == To)
+            C->Links[L].Types &= ~TypeMask;
+      mLinkSet.remove(From, To, TypeMask);
+    }
+
+    /*!
+     * Remove the node of pData, if any, along with its links. The data may
+     * already be gone: it is only used as a key. Links to the node are
+     * dropped by freeze().
+     */
+    void removeNode(const NodeT* pData)
+    {
+      assert(!mFrozen && "Cannot modify a frozen graph!");
+      typename DataToIDMap::iterator I = mDataToID.find(pData);
+      if (I == mDataToID.end())
+        return;
+      BuildNode &N = mBuildNodes[I->second];
+      for (PendingChunk *C = N.First; C; C = C->Next)
+        for (uint32_t L = 0; L != C->Size; ++L)
+          C->Links[L].Types = 0;
+      N.Erased = true;
+      ++mNumErased;
+      mDataToID.erase(I);
+    }
+
+    /*!
+     * Switch the graph to its compact form. The node carrying a null data
+     * pointer, if any, gets ID 0; nodes for [I, E) follow in that order (they
+     * are created if needed); remaining nodes are appended in creation order.
+     * Links of each node are sorted by target ID, and links to the same
+     * target merged into one carrying all their kinds.
+     */
+    template <class IterT>
+    void freeze(IterT I, IterT E)
+    {
+      assert(!mFrozen && "Graph already frozen!");
+
+      for (IterT It = I; It != E; ++It)
+        getBuildID(&*It);
+
+      // Map build IDs to final IDs; removed nodes keep none.
+      const uint32_t Unset = ~0U;
+      uint32_t NumBuildNodes = mBuildNodes.size();
+      uint32_t NumNodes = NumBuildNodes - mNumErased;
+      uint32_t *FinalID = mArena.Allocate<uint32_t>(NumBuildNodes);
+      std::fill(FinalID, FinalID + NumBuildNodes, Unset);
+      uint32_t NextID = 0;
+      typename DataToIDMap::iterator Null =
+        mDataToID.find(static_cast<const NodeT *>(0));
+      if (Null != mDataToID.end())
+        FinalID[Null->second] = NextID++;
+      for (IterT It = I; It != E; ++It)
+      {
+        uint32_t &ID = FinalID[mDataToID[&*It]];
+        if (ID == Unset)
+          ID = NextID++;
+      }
+      for (uint32_t B = 0; B != NumBuildNodes; ++B)
+        if (FinalID[B] == Unset && !mBuildNodes[B].Erased)
+          FinalID[B] = NextID++;
+
+      uint32_t *BuildID = mArena.Allocate<uint32_t>(NumNodes);
+      for (uint32_t B = 0; B != NumBuildNodes; ++B)
+        if (FinalID[B] != Unset)
+          BuildID[FinalID[B]] = B;
+
+      // Sort and merge the links of each node, then fill the CSR arrays.
+      uint32_t *EdgeBegin = mArena.Allocate<uint32_t>(NumNodes + 1);
+      uint32_t *EdgeTargets = mArena.Allocate<uint32_t>(mNumPendingLinks);
+      uint8_t *EdgeTypes = mArena.Allocate<uint8_t>(mNumPendingLinks);
+      EdgeBegin[0] = 0;
+      uint32_t Pos = 0;
+      for (uint32_t ID = 0; ID != NumNodes; ++ID)
+      {
+        mSortScratch.clear();
+        for (PendingChunk *C = mBuildNodes[BuildID[ID]].First; C; C = C->Next)
+          for (uint32_t L = 0; L != C->Size; ++L)
+          {
+            PendingLink Link = C->Links[L];
+            if (!Link.Types || FinalID[Link.Target] == Unset)
+              continue;
+            Link.Target = FinalID[Link.Target];
+            mSortScratch.push_back(Link);
+          }
+        std::sort(mSortScratch.begin(), mSortScratch.end(), LinkTargetLess());
+
+        for (typename PendingLinkList::iterator LI = mSortScratch.begin(),
+               LE = mSortScratch.end(); LI != LE; ++LI)
         {
-          RootNode = it->second;
+          if (Pos != EdgeBegin[ID] && EdgeTargets[Pos - 1] == LI->Target)
+          {
+            EdgeTypes[Pos - 1] |= LI->Types;
+            continue;
+          }
+          EdgeTargets[Pos] = LI->Target;
+          EdgeTypes[Pos] = LI->Types;
+          ++Pos;
         }
+        EdgeBegin[ID + 1] = Pos;
       }
-      return it->second;
+      mEdgeBegin = EdgeBegin;
+      mEdgeTargets = EdgeTargets;
+      mEdgeTypes = EdgeTypes;
+      mNumNodes = NumNodes;
+      mNumEdges = Pos;
+
+      buildReverseLinks();
+
+      const NodeT **Data = mArena.Allocate<const NodeT *>(NumNodes);
+      for (uint32_t ID = 0; ID != NumNodes; ++ID)
+        Data[ID] = mBuildNodes[BuildID[ID]].Data;
+      buildNodeTable(Data);
+
+      // Construction state is no longer needed. Pending links stay in the
+      // arena until the next clear().
+      mBuildNodes.clear();
+      mNumPendingLinks = 0;
+      mNumErased = 0;
+      mLinkSet.clear();
+      mFrozen = true;
+    }
+
+    /*!
+     * Freeze an empty graph over existing arrays, as laid out by a frozen
+     * graph: Data[ID] is the data of node ID, the other arrays are the ones
+     * the raw accessors expose. They are used in place, so they must live as
+     * long as the graph; if Backing is given, the graph takes it and frees it
+     * when cleared.
+     */
+    void freezeMapped(const NodeT *const *Data, uint32_t NumNodes,
+                      uint32_t NumEdges, const uint32_t *EdgeBegin,
+                      const uint32_t *EdgeTargets, const uint8_t *EdgeTypes,
+                      const uint32_t *PredBegin, const uint32_t *PredSources,
+                      const uint8_t *PredTypes, llvm::MemoryBuffer *Backing = 0)
+    {
+      assert(!mFrozen && mBuildNodes.empty() && "Graph not empty!");
+      mBacking.reset(Backing);
+      mEdgeBegin = EdgeBegin;
+      mEdgeTargets = EdgeTargets;
+      mEdgeTypes = EdgeTypes;
+      mPredBegin = PredBegin;
+      mPredSources = PredSources;
+      mPredTypes = PredTypes;
+      mNumNodes = NumNodes;
+      mNumEdges = NumEdges;
+      buildNodeTable(Data);
+      mFrozen = true;
+    }
+
+    /*!
+     * Go back to the construction phase, keeping every node and link. Nodes
+     * get their IDs back as build IDs, so freezing over the same range gives
+     * them the same IDs again.
+     */
+    void thaw()
+    {
+      assert(mFrozen && "Graph not frozen!");
+      const DependencyNode<NodeT> *Nodes = mNodes;
+      const uint32_t *EdgeBegin = mEdgeBegin;
+      const uint32_t *EdgeTargets = mEdgeTargets;
+      const uint8_t *EdgeTypes = mEdgeTypes;
+      uint32_t NumNodes = mNumNodes;
+
+      mFrozen = false;
+      mDataToID.clear();
+      reserve(NumNodes);
+      for (uint32_t ID = 0; ID != NumNodes; ++ID)
+        getBuildID(Nodes[ID].getData());
+      // Links of a frozen graph are unique, and freeze() merges whatever is
+      // added again, so they skip the duplicate check.
+      for (uint32_t ID = 0; ID != NumNodes; ++ID)
+        for (uint32_t L = EdgeBegin[ID]; L != EdgeBegin[ID + 1]; ++L)
+          appendLink(ID, EdgeTargets[L], EdgeTypes[L]);
+
+      // The frozen arrays stay in the arena until the next clear().
+      mNodes = 0;
+      mNodePtrs = 0;
+      mEdgeBegin = 0;
+      mEdgeTargets = 0;
+      mEdgeTypes = 0;
+      mPredBegin = 0;
+      mPredSources = 0;
+      mPredTypes = 0;
+      mNumNodes = 0;
+      mNumEdges = 0;
+      mHasComponents = false;
+      mBacking.reset();
+    }
+
+    /// Drop every node and link, going back to the construction phase.
+    void clear()
+    {
+      mFrozen = false;
+      mDataToID.clear();
+      mBuildNodes.clear();
+      mNumPendingLinks = 0;
+      mNumErased = 0;
+      mLinkSet.clear();
+      mNodes = 0;
+      mNodePtrs = 0;
+      mEdgeBegin = 0;
+      mEdgeTargets = 0;
+      mEdgeTypes = 0;
+      mPredBegin = 0;
+      mPredSources = 0;
+      mPredTypes = 0;
+      mNumNodes = 0;
+      mNumEdges = 0;
+      mHasComponents = false;
+      mBacking.reset();
+      mArena.reset();
+    }
+
+    bool isFrozen() const { return mFrozen; }
+
+    unsigned getNumNodes() const { return mNumNodes; }
+
+    unsigned getNumEdges() const { return mNumEdges; }
+
+    /// Number of links of the given type, among others or alone.
+    unsigned getNumEdges(DependencyType Type) const
+    {
+      return countEdges(getDependencyTypeMask(Type));
+    }
+
+    /// Number of links having at least one kind in TypeMask.
+    unsigned countEdges(unsigned TypeMask) const
+    {
+      unsigned Count = 0;
+      for (uint32_t L = 0; L != mNumEdges; ++L)
+        if (mEdgeTypes[L] & TypeMask)
+          ++Count;
+      return Count;
+    }
+
+    /// Bytes reserved by the arena holding the graph.
+    size_t getArenaMemory() const { return mArena.getTotalMemory(); }
+
+    DependencyNode<NodeT>* getRootNode() const
+    {
+      return mNumNodes ? mNodes : 0;
+    }
+
+    DependencyNode<NodeT>* getNode(uint32_t ID) const
+    {
+      assert(ID < mNumNodes && "Node ID out of range!");
+      return mNodes + ID;
+    }
+
+    DependencyNode<NodeT>* getNodeByData(const NodeT* pData)
+    {
+      return const_cast<DependencyNode<NodeT> *>(
+          static_cast<const DependencyGraph<NodeT> *>(this)->getNodeByData(pData));
     }
 
     const DependencyNode<NodeT>* getNodeByData(const NodeT* pData) const
     {
-      typename DataToNodeMap::const_iterator it = mDataToNode.find(pData);
-      if (it == mDataToNode.end())
+      assert(mFrozen && "Graph not frozen!");
+      typename DataToIDMap::const_iterator it = mDataToID.find(pData);
+      if (it == mDataToID.end())
       {
         return 0;
       }
-      return it->second;
-    }
-
-    void addDependency(const NodeT* pDependent, const NodeT* pDepency,
-            DependencyType type)
-    {
-      DependencyNode<NodeT>* pFrom = getNodeByData(pDependent);
-      DependencyNode<NodeT>* pTo = getNodeByData(pDepency);
-      pFrom->addDependencyTo(pTo, type);
+      return mNodes + it->second;
     }
 
     bool depends(const NodeT* pNode1, const NodeT* pNode2) const {
       const DependencyNode<NodeT>* pFrom = getNodeByData(pNode1);
       const DependencyNode<NodeT>* pTo = getNodeByData(pNode2);
+      if (!pFrom || !pTo)
+        return false;
       return pFrom->dependsFrom(pTo);
     }
 
+    /// Whether there is a link from node ID From to node ID To.
+    bool dependsID(uint32_t From, uint32_t To) const
+    {
+      return getLinkTypes(From, To) != 0;
+    }
+
+    /// Kinds of the link from node ID From to node ID To, 0 if none.
+    unsigned getLinkTypes(uint32_t From, uint32_t To) const
+    {
+      const uint32_t *I = targets_begin(From);
+      const uint32_t *E = targets_end(From);
+      const uint32_t *L = std::lower_bound(I, E, To);
+      if (L == E || *L != To)
+        return 0;
+      return mEdgeTypes[L - mEdgeTargets];
+    }
+
+    const uint32_t *targets_begin(uint32_t ID) const
+    {
+      return mEdgeTargets + mEdgeBegin[ID];
+    }
+
+    const uint32_t *targets_end(uint32_t ID) const
+    {
+      return mEdgeTargets + mEdgeBegin[ID + 1];
+    }
+
+    const uint8_t *types_begin(uint32_t ID) const
+    {
+      return mEdgeTypes + mEdgeBegin[ID];
+    }
+
+    /// Nodes with a link to node ID, in increasing ID order.
+    const uint32_t *sources_begin(uint32_t ID) const
+    {
+      return mPredSources + mPredBegin[ID];
+    }
+
+    const uint32_t *sources_end(uint32_t ID) const
+    {
+      return mPredSources + mPredBegin[ID + 1];
+    }
+
+    const uint8_t *source_types_begin(uint32_t ID) const
+    {
+      return mPredTypes + mPredBegin[ID];
+    }
+
+    /*!
+     * Strongly connected components of the graph, their condensed DAG and
+     * its topological levels. They are computed on the first call and kept
+     * until the graph is cleared; that first call must not race with others.
+     */
+    const DependencyComponents &getComponents() const
+    {
+      assert(mFrozen && "Graph not frozen!");
+      if (!mHasComponents)
+      {
+        mComponents.compute(mNumNodes, mEdgeBegin, mEdgeTargets);
+        mHasComponents = true;
+      }
+      return mComponents;
+    }
+
     nodes_iterator begin_children()
     {
-      return nodes_iterator(mNodes.begin());
+      return mNodePtrs;
     }
 
     nodes_iterator end_children()
     {
-      return nodes_iterator(mNodes.end());
+      return mNodePtrs + mNumNodes;
     }
 
     const_nodes_iterator begin_children() const
     {
-      return const_nodes_iterator(mNodes.begin());
+      return mNodePtrs;
     }
 
     const_nodes_iterator end_children() const
     {
-      return const_nodes_iterator(mNodes.end());
+      return mNodePtrs + mNumNodes;
     }
 
     void print(llvm::raw_ostream &OS, const char *PN) const
@@ -240,38 +809,289 @@ namespace cot
     }
 
   private:
-    typedef std::vector<DependencyNode<NodeT>* > NodeSet;
-    typedef std::map<const NodeT*, DependencyNode<NodeT>*> DataToNodeMap;
-    DependencyNode<NodeT> *RootNode;
-    NodeSet mNodes;
-    DataToNodeMap mDataToNode;
+    friend class DependencyNode<NodeT>;
+
+    DependencyGraph(const DependencyGraph<NodeT> &);
+    void operator=(const DependencyGraph<NodeT> &);
+
+    struct PendingLink
+    {
+      uint32_t Target;
+      uint8_t Types;
+    };
+
+    /// Links of a node under construction are kept in a list of arena chunks.
+    struct PendingChunk
+    {
+      PendingChunk *Next;
+      uint32_t Size;
+      uint32_t Capacity;
+      PendingLink Links[1];
+    };
+
+    struct BuildNode
+    {
+      const NodeT *Data;
+      PendingChunk *First;
+      PendingChunk *Last;
+      bool Erased;
+    };
+
+    enum
+    {
+      MinChunkLinks = 4,
+      MaxChunkLinks = 256
+    };
+
+    typedef std::vector<PendingLink> PendingLinkList;
+    typedef llvm::DenseMap<const NodeT*, uint32_t> DataToIDMap;
+
+    struct LinkTargetLess
+    {
+      bool operator()(const PendingLink &L, const PendingLink &R) const
+      {
+        return L.Target < R.Target;
+      }
+    };
+
+    uint32_t getBuildID(const NodeT* pData)
+    {
+      assert(!mFrozen && "Cannot modify a frozen graph!");
+      std::pair<typename DataToIDMap::iterator, bool> Ins =
+        mDataToID.insert(std::make_pair(pData, uint32_t(mBuildNodes.size())));
+      if (Ins.second)
+      {
+        BuildNode N = { pData, 0, 0, false };
+        mBuildNodes.push_back(N);
+        if (mLinkSet.needsGrow(mBuildNodes.size()))
+          rebuildLinkSet(mBuildNodes.size());
+      }
+      return Ins.first->second;
+    }
+
+    void appendLink(uint32_t From, uint32_t To, unsigned Types)
+    {
+      BuildNode &N = mBuildNodes[From];
+      PendingChunk *C = N.Last;
+      if (!C || C->Size == C->Capacity)
+      {
+        uint32_t Capacity = MinChunkLinks;
+        if (C)
+          Capacity = C->Capacity < MaxChunkLinks / 2 ? C->Capacity * 2
+                                                     : MaxChunkLinks;
+        PendingChunk *New = static_cast<PendingChunk *>(
+            mArena.Allocate(sizeof(PendingChunk) +
+                              (Capacity - 1) * sizeof(PendingLink),
+                            llvm::AlignOf<PendingChunk>::Alignment));
+        New->Next = 0;
+        New->Size = 0;
+        New->Capacity = Capacity;
+        if (C)
+          C->Next = New;
+        else
+          N.First = New;
+        N.Last = C = New;
+      }
+      PendingLink &L = C->Links[C->Size++];
+      L.Target = To;
+      L.Types = Types;
+      ++mNumPendingLinks;
+    }
+
+    /*!
+     * Fill the reverse CSR arrays, grouping links by target. Sources come in
+     * increasing ID order, since they are visited that way.
+     */
+    void buildReverseLinks()
+    {
+      uint32_t *PredBegin = mArena.Allocate<uint32_t>(mNumNodes + 1);
+      uint32_t *PredSources = mArena.Allocate<uint32_t>(mNumEdges);
+      uint8_t *PredTypes = mArena.Allocate<uint8_t>(mNumEdges);
+      std::fill(PredBegin, PredBegin + mNumNodes + 1, 0);
+      for (uint32_t L = 0; L != mNumEdges; ++L)
+        ++PredBegin[mEdgeTargets[L] + 1];
+      for (uint32_t ID = 0; ID != mNumNodes; ++ID)
+        PredBegin[ID + 1] += PredBegin[ID];
+      uint32_t *PredPos = mArena.Allocate<uint32_t>(mNumNodes);
+      std::copy(PredBegin, PredBegin + mNumNodes, PredPos);
+      for (uint32_t ID = 0; ID != mNumNodes; ++ID)
+        for (uint32_t L = mEdgeBegin[ID]; L != mEdgeBegin[ID + 1]; ++L)
+        {
+          uint32_t P = PredPos[mEdgeTargets[L]]++;
+          PredSources[P] = ID;
+          PredTypes[P] = mEdgeTypes[L];
+        }
+      mPredBegin = PredBegin;
+      mPredSources = PredSources;
+      mPredTypes = PredTypes;
+    }
+
+    /// Create the node of each ID, Data[ID] giving its data.
+    void buildNodeTable(const NodeT *const *Data)
+    {
+      mDataToID.clear();
+      mNodes = mArena.Allocate<DependencyNode<NodeT> >(mNumNodes);
+      mNodePtrs = mArena.Allocate<DependencyNode<NodeT> *>(mNumNodes);
+      for (uint32_t ID = 0; ID != mNumNodes; ++ID)
+      {
+        mDataToID[Data[ID]] = ID;
+        mNodePtrs[ID] = new (&mNodes[ID]) DependencyNode<NodeT>(this, Data[ID],
+                                                               ID);
+      }
+    }
+
+    /// Resize the link set for NumNodes nodes, re-inserting every link.
+    void rebuildLinkSet(unsigned NumNodes)
+    {
+      mLinkSet.reset(NumNodes);
+      for (uint32_t From = 0, FE = mBuildNodes.size(); From != FE; ++From)
+        for (PendingChunk *C = mBuildNodes[From].First; C; C = C->Next)
+          for (uint32_t L = 0; L != C->Size; ++L)
+            mLinkSet.insert(From, C->Links[L].Target, C->Links[L].Types);
+    }
+
+    DependencyNode<NodeT> *getNodeTable() const
+    {
+      return mNodes;
+    }
+
+    bool mFrozen;
+    DataToIDMap mDataToID;
+    DependencyArena mArena;
+
+    // Construction state.
+    std::vector<BuildNode> mBuildNodes;
+    uint32_t mNumPendingLinks;
+    uint32_t mNumErased;
+    DependencyLinkSet mLinkSet;
+    PendingLinkList mSortScratch;
+
+    // Frozen state, allocated in mArena or mapped from mBacking.
+    DependencyNode<NodeT> *mNodes;
+    DependencyNode<NodeT> **mNodePtrs;
+    const uint32_t *mEdgeBegin;
+    const uint32_t *mEdgeTargets;
+    const uint8_t *mEdgeTypes;
+    const uint32_t *mPredBegin;
+    const uint32_t *mPredSources;
+    const uint8_t *mPredTypes;
+    llvm::OwningPtr<llvm::MemoryBuffer> mBacking;
+    uint32_t mNumNodes;
+    uint32_t mNumEdges;
+
+    // Lazily computed analyses of the frozen graph.
+    mutable DependencyComponents mComponents;
+    mutable bool mHasComponents;
   };
 
+  template <class NodeT>
+  typename DependencyNode<NodeT>::iterator DependencyNode<NodeT>::begin() const
+  {
+    return iterator(mpGraph->targets_begin(mID), mpGraph->types_begin(mID),
+                    mpGraph->getNodeTable());
+  }
+
+  template <class NodeT>
+  typename DependencyNode<NodeT>::iterator DependencyNode<NodeT>::end() const
+  {
+    return iterator(mpGraph->targets_end(mID), 0, mpGraph->getNodeTable());
+  }
+
+  template <class NodeT>
+  typename DependencyNode<NodeT>::source_iterator
+  DependencyNode<NodeT>::source_begin() const
+  {
+    return source_iterator(mpGraph->sources_begin(mID),
+                           mpGraph->source_types_begin(mID),
+                           mpGraph->getNodeTable());
+  }
+
+  template <class NodeT>
+  typename DependencyNode<NodeT>::source_iterator
+  DependencyNode<NodeT>::source_end() const
+  {
+    return source_iterator(mpGraph->sources_end(mID), 0,
+                           mpGraph->getNodeTable());
+  }
+
+  template <class NodeT>
+  bool DependencyNode<NodeT>::dependsFrom(const DependencyNode<NodeT>* pNode) const
+  {
+    return mpGraph->dependsID(mID, pNode->getID());
+  }
+
   typedef DependencyGraph<llvm::BasicBlock> DepGraph;
 
 
   /*!
-   * Overloaded operator that pretty print a DependencyNode
+   * Print the name of the value a node stands for.
    */
   template<class NodeT>
-  static llvm::raw_ostream &operator<<(llvm::raw_ostream &o,
-                                       const DependencyNode<NodeT> *N)
+  static void WriteNodeName(llvm::raw_ostream &o,
+                            const DependencyNode<NodeT> *N)
   {
-    const NodeT *block = N->getData();
-    if (block)
-      WriteAsOperand(o, block, false);
-    else
+    WriteAsOperand(o, N->getData(), false);
+  }
+
+  /*!
+   * Instructions are printed as their node ID, which follows the instruction
+   * numbering of the function: those without a result have no name.
+   */
+  inline void WriteNodeName(llvm::raw_ostream &o,
+                            const DependencyNode<llvm::Instruction> *N)
+  {
+    o << '#' << N->getID();
+  }
+
+  /*!
+   * Print the label of a node: the name of its value, or what a synthetic
+   * node stands for.
+   */
+  template<class NodeT>
+  static void WriteNodeLabel(llvm::raw_ostream &o,
+                             const DependencyNode<NodeT> *N)
+  {
+    if (!N->getData())
       o << "<<EntryNode>>";
+    else if (N->getData() == getMemoryStateData<NodeT>())
+      o << "<<MemoryState>>";
+    else
+      WriteNodeName(o, N);
+  }
+
+  /*!
+   * Print a node and its links having a kind in TypeMask. A link of both
+   * types is listed once for each of them, data before control.
+   */
+  template<class NodeT>
+  static void PrintDependencyNode(llvm::raw_ostream &o,
+                                  const DependencyNode<NodeT> *N,
+                                  unsigned TypeMask)
+  {
+    WriteNodeLabel(o, N);
     o << " { ";
     typename DependencyNode<NodeT>::const_iterator I = N->begin();
     typename DependencyNode<NodeT>::const_iterator E = N->end();
     for (; I != E; ++I)
-    {
-      WriteAsOperand(o, (*I)->getData(), false);
-      o << ":" << I.getDependencyType() << " ";
-    }
-    o << "}";
-    return o << "\n";
+      for (unsigned T = NumDependencyTypes; T-- != 0; )
+        if (I.getTypeMask() & TypeMask &
+            getDependencyTypeMask(static_cast<DependencyType>(T)))
+        {
+          WriteNodeLabel(o, *I);
+          o << ":" << T << " ";
+        }
+    o << "}\n";
+  }
+
+  /*!
+   * Overloaded operator that pretty print a DependencyNode
+   */
+  template<class NodeT>
+  static llvm::raw_ostream &operator<<(llvm::raw_ostream &o,
+                                       const DependencyNode<NodeT> *N)
+  {
+    PrintDependencyNode(o, N, ~0U);
+    return o;
   }
 
 
@@ -289,6 +1109,234 @@ namespace cot
       o << *I;
     }
   }
+
+
+  /*!
+   * Iterator over the links of a node having a kind in a mask.
+   */
+  template <class NodeT = llvm::BasicBlock>
+  class DependencyViewIterator
+      : public std::iterator<std::input_iterator_tag, DependencyNode<NodeT> >
+  {
+  public:
+    DependencyViewIterator() : mTypeMask(0) {}
+
+    DependencyViewIterator(DependencyLinkIterator<NodeT> I,
+                           DependencyLinkIterator<NodeT> E, unsigned TypeMask)
+        : mI(I), mE(E), mTypeMask(TypeMask)
+    {
+      skip();
+    }
+
+    DependencyViewIterator<NodeT> &operator++()
+    {
+      ++mI;
+      skip();
+      return *this;
+    }
+
+    DependencyViewIterator<NodeT> operator++(int)
+    {
+      DependencyViewIterator<NodeT> old = *this;
+      ++*this;
+      return old;
+    }
+
+    DependencyNode<NodeT> *operator->() const
+    {
+      return *mI;
+    }
+
+    DependencyNode<NodeT> *operator*() const
+    {
+      return *mI;
+    }
+
+    bool operator!=(const DependencyViewIterator &r) const
+    {
+      return mI != r.mI;
+    }
+
+    bool operator==(const DependencyViewIterator &r) const
+    {
+      return !(operator!=(r));
+    }
+
+    /// Kinds of the link within the mask.
+    unsigned getTypeMask() const
+    {
+      return mI.getTypeMask() & mTypeMask;
+    }
+
+    bool hasType(DependencyType Type) const
+    {
+      return getTypeMask() & getDependencyTypeMask(Type);
+    }
+
+    bool hasKind(DependencyKind Kind) const
+    {
+      return getTypeMask() & (1U << Kind);
+    }
+
+  private:
+    void skip()
+    {
+      while (mI != mE && !(mI.getTypeMask() & mTypeMask))
+        ++mI;
+    }
+
+    DependencyLinkIterator<NodeT> mI;
+    DependencyLinkIterator<NodeT> mE;
+    unsigned mTypeMask;
+  };
+
+
+  /*!
+   * View of the links of a frozen graph having a kind in a mask, such as
+   * the control or the data layer of a graph holding both. The nodes are
+   * those of the graph, except for the entry node, which only belongs to
+   * views of control links, and the memory state node, which only belongs to
+   * views of data links. The view is valid as long as the graph is frozen.
+   */
+  template <class NodeT = llvm::BasicBlock>
+  class DependencyGraphView
+  {
+  public:
+    typedef typename DependencyGraph<NodeT>::const_nodes_iterator
+      nodes_iterator;
+    typedef DependencyViewIterator<NodeT> iterator;
+
+    DependencyGraphView() : mGraph(0), mTypeMask(0) { }
+
+    DependencyGraphView(const DependencyGraph<NodeT> &G, unsigned TypeMask) :
+    mGraph(&G), mTypeMask(TypeMask) { }
+
+    const DependencyGraph<NodeT> &getGraph() const { return *mGraph; }
+
+    unsigned getTypeMask() const { return mTypeMask; }
+
+    /// ID of the first node of the view; the following ones all belong to it.
+    uint32_t getFirstID() const
+    {
+      if (mTypeMask & ControlTypeMask)
+        return 0;
+      const DependencyNode<NodeT> *Root = mGraph->getRootNode();
+      return Root && !Root->getData() ? 1 : 0;
+    }
+
+    /*!
+     * ID past the last node of the view. The memory state node is not in
+     * the range of blocks a graph is frozen with, so it comes last.
+     */
+    uint32_t getEndID() const
+    {
+      uint32_t NumNodes = mGraph->getNumNodes();
+      if ((mTypeMask & DataTypeMask) || !NumNodes)
+        return NumNodes;
+      const NodeT *Last = mGraph->getNode(NumNodes - 1)->getData();
+      return Last == getMemoryStateData<NodeT>() ? NumNodes - 1 : NumNodes;
+    }
+
+    unsigned getNumNodes() const
+    {
+      return getEndID() - getFirstID();
+    }
+
+    unsigned getNumEdges() const
+    {
+      return mGraph->countEdges(mTypeMask);
+    }
+
+    unsigned getNumEdges(DependencyType Type) const
+    {
+      return mGraph->countEdges(mTypeMask & getDependencyTypeMask(Type));
+    }
+
+    nodes_iterator begin_children() const
+    {
+      return mGraph->begin_children() + getFirstID();
+    }
+
+    nodes_iterator end_children() const
+    {
+      return mGraph->begin_children() + getEndID();
+    }
+
+    /// Links of N in the view.
+    iterator begin(const DependencyNode<NodeT> *N) const
+    {
+      return iterator(N->begin(), N->end(), mTypeMask);
+    }
+
+    iterator end(const DependencyNode<NodeT> *N) const
+    {
+      return iterator(N->end(), N->end(), mTypeMask);
+    }
+
+    const DependencyNode<NodeT> *getNodeByData(const NodeT *pData) const
+    {
+      const DependencyNode<NodeT> *N = mGraph->getNodeByData(pData);
+      if (!N || N->getID() < getFirstID() || N->getID() >= getEndID())
+        return 0;
+      return N;
+    }
+
+    bool dependsID(uint32_t From, uint32_t To) const
+    {
+      return mGraph->getLinkTypes(From, To) & mTypeMask;
+    }
+
+    bool depends(const NodeT *pNode1, const NodeT *pNode2) const
+    {
+      const DependencyNode<NodeT> *pFrom = getNodeByData(pNode1);
+      const DependencyNode<NodeT> *pTo = getNodeByData(pNode2);
+      if (!pFrom || !pTo)
+        return false;
+      return dependsID(pFrom->getID(), pTo->getID());
+    }
+
+    void print(llvm::raw_ostream &OS, const char *PN) const
+    {
+      OS << "=============================--------------------------------\n";
+      OS << PN << ": \n";
+      for (nodes_iterator I = begin_children(), E = end_children(); I != E;
+           ++I)
+      {
+        OS.indent(4);
+        PrintDependencyNode(OS, *I, mTypeMask);
+      }
+    }
+
+  private:
+    const DependencyGraph<NodeT> *mGraph;
+    unsigned mTypeMask;
+  };
+
+  typedef DependencyGraphView<llvm::BasicBlock> DepGraphView;
+
+
+  /*!
+   * Graph traits of the views of block graphs keeping the links with a kind
+   * in TypeMask. The traits of the analyses exposing such a view derive from
+   * them, adding how to reach its nodes.
+   */
+  template <unsigned TypeMask>
+  struct DependencyViewGraphTraits
+  {
+    typedef DepGraphNode NodeType;
+    typedef DependencyViewIterator<> ChildIteratorType;
+    typedef DepGraphView::nodes_iterator nodes_iterator;
+
+    static NodeType *getEntryNode(NodeType *N) {
+      return N;
+    }
+    static inline ChildIteratorType child_begin(NodeType *N) {
+      return ChildIteratorType(N->begin(), N->end(), TypeMask);
+    }
+    static inline ChildIteratorType child_end(NodeType *N) {
+      return ChildIteratorType(N->end(), N->end(), TypeMask);
+    }
+  };
 }
 
 
@@ -338,6 +1386,44 @@ template <> struct GraphTraits<cot::DepGraph *>
   }
 };
 
+
+/*!
+ * Inverse traversals, such as idf_iterator, follow the reverse links: each
+ * step reads the sources of a node from the CSR arrays freezing built.
+ */
+template <> struct GraphTraits<Inverse<cot::DepGraphNode*> >
+{
+  typedef cot::DepGraphNode                 NodeType;
+  typedef NodeType::source_iterator         ChildIteratorType;
+
+  static NodeType *getEntryNode(Inverse<cot::DepGraphNode *> G) {
+    return G.Graph;
+  }
+  static inline ChildIteratorType child_begin(NodeType *N) {
+    return N->source_begin();
+  }
+  static inline ChildIteratorType child_end(NodeType *N) {
+    return N->source_end();
+  }
+};
+
+
+template <> struct GraphTraits<Inverse<cot::DepGraph *> >
+    : public GraphTraits<Inverse<cot::DepGraphNode*> > {
+  static NodeType *getEntryNode(Inverse<cot::DepGraph *> G) {
+    return *(G.Graph->begin_children());
+  }
+
+  typedef cot::DepGraph::const_nodes_iterator nodes_iterator;
+  static nodes_iterator nodes_begin(Inverse<cot::DepGraph *> G) {
+    return G.Graph->begin_children();
+  }
+
+  static nodes_iterator nodes_end(Inverse<cot::DepGraph *> G) {
+    return G.Graph->end_children();
+  }
+};
+
 }
 
 #endif // DEPENDENCYGRAPH_H_
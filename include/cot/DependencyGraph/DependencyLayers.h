@@ -0,0 +1,120 @@
+/** ---*- C++ -*--- DependencyLayers.h
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+
+
+#ifndef DEPENDENCYLAYERS_H
+#define DEPENDENCYLAYERS_H
+
+#include "cot/DependencyGraph/DependencyGraph.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/DataTypes.h"
+
+namespace llvm
+{
+  class Function;
+}
+
+namespace cot
+{
+  /*!
+   * Block-level dependency graph of a function, shared by the control, data
+   * and program dependency graph analyses. The first two each add a layer of
+   * links of their own type over the same nodes, and the analyses expose
+   * views of the layers they stand for: the program dependency graph is the
+   * view of both, and needs no graph of its own.
+   *
+   * The graph is emptied each time the pass runs on a function. Adding a
+   * layer thaws the graph, and freezing it again stores a link between two
+   * blocks once, with the types of every layer it belongs to.
+   */
+  class DependencyLayers : public llvm::FunctionPass
+  {
+  public:
+    static char ID; // Pass ID, replacement for typeid
+
+    DependencyLayers() :
+    llvm::FunctionPass(ID), mTypeMask(0), mHash(0), mHasHash(false) { }
+
+    bool runOnFunction(llvm::Function &F);
+
+    void getAnalysisUsage(llvm::AnalysisUsage &AU) const;
+
+    const char *getPassName() const
+    {
+      return "Dependency Graph Layers";
+    }
+
+    const DepGraph &getGraph() const { return mGraph; }
+
+    /// Kinds of the layers built so far, as the union of their type masks.
+    unsigned getTypeMask() const { return mTypeMask; }
+
+    bool hasLayer(DependencyType Type) const
+    {
+      return mTypeMask & getDependencyTypeMask(Type);
+    }
+
+    /// View of the links having a kind in TypeMask.
+    DepGraphView getView(unsigned TypeMask) const
+    {
+      return DepGraphView(mGraph, TypeMask);
+    }
+
+    /*!
+     * Load the graph holding the layer of Type along with those already
+     * built from the cache, if it is enabled. Return false if it was not
+     * found, the graph being left untouched.
+     */
+    bool loadLayer(llvm::Function &F, DependencyType Type);
+
+    /*!
+     * Start adding the layer of Type. The graph is returned in its
+     * construction phase, holding the links of the other layers.
+     */
+    DepGraph &beginLayer(DependencyType Type);
+
+    /// Freeze the graph of F with the new layer, and cache it if enabled.
+    void endLayer(llvm::Function &F, DependencyType Type);
+
+    /*!
+     * Start changing the layers already built, after F was transformed. The
+     * graph is returned in its construction phase.
+     */
+    DepGraph &beginUpdate();
+
+    /*!
+     * Freeze the updated graph of F. It is not cached: its key would take
+     * hashing the whole function again, and the cached graphs of the
+     * function before the change stay valid for that IR.
+     */
+    void endUpdate(llvm::Function &F);
+
+  private:
+    uint64_t getHash(llvm::Function &F);
+
+    DepGraph mGraph;
+    unsigned mTypeMask;
+
+    // Cache key of the function, computed on first use.
+    uint64_t mHash;
+    bool mHasHash;
+  };
+}
+
+#endif // DEPENDENCYLAYERS_H
@@ -0,0 +1,297 @@
+/** ---*- C++ -*--- DependencyQueries.h
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+
+
+#ifndef DEPENDENCYQUERIES_H
+#define DEPENDENCYQUERIES_H
+
+#include "cot/DependencyGraph/DependencyGraph.h"
+#include "cot/DependencyGraph/LinkSearch.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Support/DataTypes.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+namespace cot
+{
+  /*!
+   * Link queries on a frozen dependency graph, asked many at a time or one
+   * at a time through a memo.
+   *
+   * A batch is answered by source node: the queries are sorted by source
+   * and target, so the targets of each source are read once, in increasing
+   * order. Answers are bitsets, bit i answering query i.
+   *
+   * Point queries on node data can go through a memo of the last answers,
+   * dropping the least recently used one when full. A hit costs one hash
+   * lookup instead of a lookup for each node and a search of the links.
+   *
+   * Links are searched with SearchT, one of the policies of LinkSearch.h,
+   * chosen for the degree of the nodes of the graph.
+   *
+   * The answers stay valid as long as the graph is frozen; clearMemo()
+   * must be called once it changes. Queries use scratch state, so
+   * concurrent ones need one object per thread.
+   */
+  template <class NodeT = llvm::BasicBlock,
+            class SearchT = SortedLinkSearch>
+  class DependencyQueries
+  {
+  public:
+    /// Source and target node IDs of a query.
+    typedef std::pair<uint32_t, uint32_t> Query;
+    typedef std::pair<const NodeT *, const NodeT *> DataQuery;
+
+    /// A memo of MemoSize answers; without one, point queries are not kept.
+    explicit DependencyQueries(const DependencyGraph<NodeT> &G,
+                               unsigned MemoSize = 0) :
+    mGraph(G), mMemoSize(MemoSize), mHead(NoEntry), mTail(NoEntry),
+    mNumHits(0), mNumMisses(0)
+    {
+      assert(G.isFrozen() && "Graph not frozen!");
+      mSearch.build(G);
+    }
+
+    /*!
+     * Whether there is a link with a kind in TypeMask for each query in
+     * [I, E). The result stays valid until the next batch.
+     */
+    template <class IterT>
+    const llvm::BitVector &dependsBatch(IterT I, IterT E,
+                                        unsigned TypeMask = ~0U)
+    {
+      mOrder.clear();
+      for (uint32_t Index = 0; I != E; ++I, ++Index)
+        mOrder.push_back(Pending(I->first, I->second, Index));
+      return answer(TypeMask);
+    }
+
+    /*!
+     * As dependsBatch(), for queries on node data. Nodes not in the graph
+     * have no links.
+     */
+    template <class IterT>
+    const llvm::BitVector &dependsDataBatch(IterT I, IterT E,
+                                            unsigned TypeMask = ~0U)
+    {
+      mOrder.clear();
+      for (uint32_t Index = 0; I != E; ++I, ++Index)
+      {
+        const DependencyNode<NodeT> *From = mGraph.getNodeByData(I->first);
+        const DependencyNode<NodeT> *To = mGraph.getNodeByData(I->second);
+        if (From && To)
+          mOrder.push_back(Pending(From->getID(), To->getID(), Index));
+        else
+          mOrder.push_back(Pending(NoEntry, NoEntry, Index));
+      }
+      return answer(TypeMask);
+    }
+
+    /*!
+     * Whether there is a link with a kind in TypeMask from node ID From to
+     * each node ID in [I, E).
+     */
+    template <class IterT>
+    const llvm::BitVector &dependsManyBatch(uint32_t From, IterT I, IterT E,
+                                           unsigned TypeMask = ~0U)
+    {
+      mOrder.clear();
+      for (uint32_t Index = 0; I != E; ++I, ++Index)
+        mOrder.push_back(Pending(From, *I, Index));
+      return answer(TypeMask);
+    }
+
+    /*!
+     * Kinds of the link from the node of From to the node of To, 0 if there
+     * is none, through the memo if there is one.
+     */
+    unsigned getLinkTypes(const NodeT *From, const NodeT *To)
+    {
+      if (!mMemoSize)
+        return lookup(From, To);
+
+      DataQuery Key(From, To);
+      typename MemoIndex::iterator It = mMemoIndex.find(Key);
+      if (It != mMemoIndex.end())
+      {
+        ++mNumHits;
+        touch(It->second);
+        return mMemo[It->second].Types;
+      }
+      ++mNumMisses;
+      unsigned Types = lookup(From, To);
+      insert(Key, Types);
+      return Types;
+    }
+
+    bool depends(const NodeT *From, const NodeT *To, unsigned TypeMask = ~0U)
+    {
+      return getLinkTypes(From, To) & TypeMask;
+    }
+
+    void clearMemo()
+    {
+      mMemo.clear();
+      mMemoIndex.clear();
+      mHead = mTail = NoEntry;
+    }
+
+    unsigned getNumHits() const { return mNumHits; }
+
+    unsigned getNumMisses() const { return mNumMisses; }
+
+  private:
+    static const uint32_t NoEntry = ~0U;
+
+    /// A query of a batch, along with its position in it.
+    struct Pending
+    {
+      uint32_t From;
+      uint32_t To;
+      uint32_t Index;
+
+      Pending(uint32_t pFrom, uint32_t pTo, uint32_t pIndex) :
+      From(pFrom), To(pTo), Index(pIndex) { }
+
+      bool operator<(const Pending &RHS) const
+      {
+        if (From != RHS.From)
+          return From < RHS.From;
+        return To < RHS.To;
+      }
+    };
+
+    /// A memoized answer, in a list from the most to the least recent one.
+    struct MemoEntry
+    {
+      DataQuery Key;
+      unsigned Types;
+      uint32_t Prev;
+      uint32_t Next;
+    };
+
+    typedef llvm::DenseMap<DataQuery, uint32_t> MemoIndex;
+
+    /// Answer the queries in mOrder, sorting them by source and target.
+    const llvm::BitVector &answer(unsigned TypeMask)
+    {
+      mResult.reset();
+      mResult.resize(mOrder.size());
+      std::sort(mOrder.begin(), mOrder.end());
+
+      typename std::vector<Pending>::const_iterator I = mOrder.begin();
+      typename std::vector<Pending>::const_iterator E = mOrder.end();
+      while (I != E && I->From != NoEntry)
+      {
+        uint32_t From = I->From;
+        // Targets are sorted too: each search starts where the last ended.
+        const uint32_t *Hint = mGraph.targets_begin(From);
+        for (; I != E && I->From == From; ++I)
+          if (mSearch.getLinkTypes(mGraph, From, I->To, Hint) & TypeMask)
+            mResult.set(I->Index);
+      }
+      return mResult;
+    }
+
+    unsigned lookup(const NodeT *From, const NodeT *To) const
+    {
+      const DependencyNode<NodeT> *pFrom = mGraph.getNodeByData(From);
+      const DependencyNode<NodeT> *pTo = mGraph.getNodeByData(To);
+      if (!pFrom || !pTo)
+        return 0;
+      const uint32_t *Hint = mGraph.targets_begin(pFrom->getID());
+      return mSearch.getLinkTypes(mGraph, pFrom->getID(), pTo->getID(), Hint);
+    }
+
+    void unlink(uint32_t Entry)
+    {
+      MemoEntry &M = mMemo[Entry];
+      if (M.Prev != NoEntry)
+        mMemo[M.Prev].Next = M.Next;
+      else
+        mHead = M.Next;
+      if (M.Next != NoEntry)
+        mMemo[M.Next].Prev = M.Prev;
+      else
+        mTail = M.Prev;
+    }
+
+    void pushFront(uint32_t Entry)
+    {
+      MemoEntry &M = mMemo[Entry];
+      M.Prev = NoEntry;
+      M.Next = mHead;
+      if (mHead != NoEntry)
+        mMemo[mHead].Prev = Entry;
+      mHead = Entry;
+      if (mTail == NoEntry)
+        mTail = Entry;
+    }
+
+    void touch(uint32_t Entry)
+    {
+      if (Entry == mHead)
+        return;
+      unlink(Entry);
+      pushFront(Entry);
+    }
+
+    void insert(const DataQuery &Key, unsigned Types)
+    {
+      uint32_t Entry;
+      if (mMemo.size() < mMemoSize)
+      {
+        Entry = mMemo.size();
+        mMemo.push_back(MemoEntry());
+      }
+      else
+      {
+        // Reuse the least recently used entry.
+        Entry = mTail;
+        unlink(Entry);
+        mMemoIndex.erase(mMemo[Entry].Key);
+      }
+      mMemo[Entry].Key = Key;
+      mMemo[Entry].Types = Types;
+      mMemoIndex[Key] = Entry;
+      pushFront(Entry);
+    }
+
+    const DependencyGraph<NodeT> &mGraph;
+    SearchT mSearch;
+
+    // Batch scratch state.
+    std::vector<Pending> mOrder;
+    llvm::BitVector mResult;
+
+    // Memo of point queries.
+    unsigned mMemoSize;
+    std::vector<MemoEntry> mMemo;
+    MemoIndex mMemoIndex;
+    uint32_t mHead;
+    uint32_t mTail;
+    unsigned mNumHits;
+    unsigned mNumMisses;
+  };
+}
+
+#endif // DEPENDENCYQUERIES_H
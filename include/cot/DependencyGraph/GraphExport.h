@@ -0,0 +1,200 @@
+/** ---*- C++ -*--- GraphExport.h
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef GRAPHEXPORT_H
+#define GRAPHEXPORT_H
+
+#include "cot/DependencyGraph/DependencyGraph.h"
+#include "llvm/Pass.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <string>
+
+namespace cot
+{
+  enum ExportFormat
+  {
+    DOTExport,
+    JSONExport
+  };
+
+  /// What exportGraph writes.
+  struct ExportOptions
+  {
+    ExportOptions() : Format(DOTExport), IDsOnly(false), TypeMask(~0U),
+                      Nodes(0) { }
+
+    ExportFormat Format;
+
+    /// Omit node labels, leaving only node IDs.
+    bool IDsOnly;
+
+    /// Only links with a kind in the mask, as 1 << Kind, are written.
+    unsigned TypeMask;
+
+    /// If given, only these nodes and the links among them are written.
+    const llvm::BitVector *Nodes;
+  };
+
+  /// Write S quoted and escaped as a string of the given format.
+  void writeQuoted(llvm::raw_ostream &OS, llvm::StringRef S,
+                   ExportFormat Format);
+
+  /// Write the end of a JSON link record, listing the kinds in KindMask.
+  void writeKinds(llvm::raw_ostream &OS, unsigned KindMask);
+
+  /*!
+   * Stream View to OS, one node or link at a time, as a DOT digraph or as
+   * newline-delimited JSON: a "graph" record counting the records that
+   * follow, then a record per node and one per link and type, listing the
+   * kinds of the link within that type.
+   * Nodes are named by their ID and, unless IDsOnly
+   * is set, labelled with the short name printed by the graph, never with
+   * the text of their block. Memory use does not depend on the size of the
+   * graph.
+   */
+  template <class NodeT>
+  void exportGraph(llvm::raw_ostream &OS,
+                   const DependencyGraphView<NodeT> &View,
+                   llvm::StringRef Name, const ExportOptions &Opts)
+  {
+    const DependencyGraph<NodeT> &G = View.getGraph();
+    unsigned TypeMask = Opts.TypeMask & View.getTypeMask();
+    bool DOT = Opts.Format == DOTExport;
+    if (DOT)
+    {
+      OS << "digraph ";
+      writeQuoted(OS, Name, Opts.Format);
+      OS << " {\n";
+    }
+    else
+    {
+      // The counts are those of the records below, under the same filters.
+      unsigned NumNodes = 0, NumLinks = 0;
+      for (uint32_t ID = View.getFirstID(), E = View.getEndID(); ID != E;
+           ++ID)
+      {
+        if (Opts.Nodes && !Opts.Nodes->test(ID))
+          continue;
+        ++NumNodes;
+        const uint32_t *T = G.targets_begin(ID);
+        const uint8_t *Types = G.types_begin(ID);
+        for (const uint32_t *TE = G.targets_end(ID); T != TE; ++T, ++Types)
+          if (!Opts.Nodes || Opts.Nodes->test(*T))
+            NumLinks += ((TypeMask & *Types & DataTypeMask) != 0) +
+                        ((TypeMask & *Types & ControlTypeMask) != 0);
+      }
+      OS << "{\"graph\":";
+      writeQuoted(OS, Name, Opts.Format);
+      OS << ",\"nodes\":" << NumNodes << ",\"links\":" << NumLinks
+         << "}\n";
+    }
+
+    llvm::SmallString<64> Label;
+    for (uint32_t ID = View.getFirstID(), E = View.getEndID(); ID != E; ++ID)
+    {
+      if (Opts.Nodes && !Opts.Nodes->test(ID))
+        continue;
+
+      OS << (DOT ? "  n" : "{\"node\":") << ID;
+      if (!Opts.IDsOnly)
+      {
+        const DependencyNode<NodeT> *N = G.getNode(ID);
+        Label.clear();
+        llvm::raw_svector_ostream LS(Label);
+        WriteNodeLabel(LS, N);
+        OS << (DOT ? " [label=" : ",\"label\":");
+        writeQuoted(OS, LS.str(), Opts.Format);
+        if (DOT)
+          OS << ']';
+      }
+      OS << (DOT ? ";\n" : "}\n");
+    }
+
+    for (uint32_t ID = View.getFirstID(), E = View.getEndID(); ID != E; ++ID)
+    {
+      if (Opts.Nodes && !Opts.Nodes->test(ID))
+        continue;
+      const uint32_t *T = G.targets_begin(ID);
+      const uint8_t *Types = G.types_begin(ID);
+      for (const uint32_t *TE = G.targets_end(ID); T != TE; ++T, ++Types)
+      {
+        if (!(TypeMask & *Types) || (Opts.Nodes && !Opts.Nodes->test(*T)))
+          continue;
+        // As when printing, data comes before control.
+        if (TypeMask & *Types & DataTypeMask)
+        {
+          if (DOT)
+            OS << "  n" << ID << " -> n" << *T << ";\n";
+          else
+          {
+            OS << "{\"from\":" << ID << ",\"to\":" << *T
+               << ",\"type\":\"data\"";
+            writeKinds(OS, TypeMask & *Types & DataTypeMask);
+          }
+        }
+        if (TypeMask & *Types & ControlTypeMask)
+        {
+          if (DOT)
+            OS << "  n" << ID << " -> n" << *T << " [style=dotted];\n";
+          else
+          {
+            OS << "{\"from\":" << ID << ",\"to\":" << *T
+               << ",\"type\":\"control\"";
+            writeKinds(OS, TypeMask & *Types & ControlTypeMask);
+          }
+        }
+      }
+    }
+
+    if (DOT)
+      OS << "}\n";
+  }
+
+  /*!
+   * Export the graph of an analysis pass to a file per function, or to the
+   * file given by -dg-export-file; options of the form -dg-export-* select
+   * the format and what is written.
+   */
+  class DependencyGraphExporter : public llvm::FunctionPass
+  {
+  public:
+    DependencyGraphExporter(char &ID, llvm::StringRef Name) :
+    llvm::FunctionPass(ID), mName(Name) { }
+
+    bool runOnFunction(llvm::Function &F);
+
+    bool doFinalization(llvm::Module &M);
+
+  protected:
+    /// The graph of F, from the analysis the exporter requires.
+    virtual DepGraphView getGraph(llvm::Function &F) = 0;
+
+  private:
+    std::string mName;
+
+    /// Output shared by every function, if -dg-export-file is given.
+    llvm::OwningPtr<llvm::raw_fd_ostream> mOutput;
+  };
+}
+
+#endif // GRAPHEXPORT_H
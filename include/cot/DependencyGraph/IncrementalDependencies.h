@@ -0,0 +1,135 @@
+/** ---*- C++ -*--- IncrementalDependencies.h
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+
+
+#ifndef INCREMENTALDEPENDENCIES_H
+#define INCREMENTALDEPENDENCIES_H
+
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/Support/ValueHandle.h"
+
+#include <list>
+#include <vector>
+
+namespace llvm
+{
+  class AliasAnalysis;
+  class BasicBlock;
+  class Function;
+  class Instruction;
+  class MemoryDependenceAnalysis;
+  template <class NodeT> class DominatorTreeBase;
+}
+
+namespace cot
+{
+  class DependencyLayers;
+
+  /*!
+   * Keep the graph shared through DependencyLayers up to date while a
+   * function is transformed, so that the transform can preserve the control,
+   * data and program dependency graphs.
+   *
+   * The transform reports its edits once made; erased blocks are tracked on
+   * their own. update() then recomputes only the links the edits may have
+   * changed:
+   *
+   *  - control links from the blocks whose successors changed, and from the
+   *    blocks with an edge into the post-dominator subtree of a block whose
+   *    immediate post-dominator changed;
+   *  - data links from and to the blocks whose instructions changed, and the
+   *    links into the blocks they shared a memory link with or reachable
+   *    from them with a store that may alias one of theirs, MDA being
+   *    queried again for the stores of these blocks only.
+   *
+   * Updating the post-dominator tree, with the local updates of
+   * DominatorTreeBase such as splitBlock(), and MDA is up to the transform.
+   * A store whose memory dependences an edit changes otherwise, for instance
+   * through a new CFG path, must be reported through its block. Alias set
+   * pairs depend on whole sets, and summarized memory links on every block,
+   * so with -ddg-alias-sets or a memory link budget the data layer is
+   * rebuilt instead.
+   *
+   * Only the analysis queries are limited to what the edit touched. The
+   * graph is thawed and frozen again around them, which takes time linear
+   * in the number of its nodes and links whatever the size of the edit.
+   */
+  class DependencyUpdater
+  {
+  public:
+    DependencyUpdater(llvm::Function &F, DependencyLayers &Layers);
+
+    /// BB was added to the function, with its instructions and successors.
+    void blockInserted(llvm::BasicBlock *BB);
+
+    /// CFG edges leaving BB were added or removed.
+    void successorsChanged(llvm::BasicBlock *BB);
+
+    /// The immediate post-dominator of BB changed.
+    void postDominatorChanged(llvm::BasicBlock *BB);
+
+    /// Instructions of BB were added, erased, moved or given new operands.
+    void instructionsChanged(llvm::BasicBlock *BB);
+
+    /// I was moved to its block from From.
+    void instructionMoved(llvm::Instruction *I, llvm::BasicBlock *From);
+
+    bool hasPendingUpdates() const;
+
+    /*!
+     * Update the graph for the edits reported so far. PDT is needed when the
+     * control layer is built, AA and MDA when the data one is; they must be
+     * up to date with the function.
+     */
+    void update(llvm::DominatorTreeBase<llvm::BasicBlock> *PDT,
+                llvm::AliasAnalysis *AA, llvm::MemoryDependenceAnalysis *MDA);
+
+  private:
+    /// Handle telling the updater when its block is erased.
+    class BlockHandle : public llvm::CallbackVH
+    {
+    public:
+      BlockHandle(llvm::BasicBlock *BB, DependencyUpdater *Updater);
+
+      virtual void deleted();
+
+    private:
+      DependencyUpdater *mUpdater;
+    };
+
+    typedef llvm::SmallPtrSet<llvm::BasicBlock *, 16> BlockSet;
+
+    DependencyUpdater(const DependencyUpdater &);
+    void operator=(const DependencyUpdater &);
+
+    void blockErased(llvm::BasicBlock *BB);
+
+    llvm::Function &mF;
+    DependencyLayers &mLayers;
+    std::list<BlockHandle> mHandles;
+
+    // Edits waiting for update().
+    BlockSet mSuccessorsChanged;
+    BlockSet mPostDominatorChanged;
+    BlockSet mInstructionsChanged;
+    std::vector<const llvm::BasicBlock *> mErased;
+  };
+}
+
+#endif // INCREMENTALDEPENDENCIES_H
@@ -0,0 +1,96 @@
+/** ---*- C++ -*--- InstructionDependencies.h
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef INSTRUCTIONDEPENDENCIES_H
+#define INSTRUCTIONDEPENDENCIES_H
+
+#include "cot/DependencyGraph/DependencyGraph.h"
+#include "llvm/Instruction.h"
+#include "llvm/Pass.h"
+
+namespace llvm
+{
+  class Function;
+}
+
+namespace cot
+{
+  struct MemoryDependences;
+
+  /*!
+   * Dependency graph among the instructions of a function. Once frozen, the
+   * node of the n-th instruction of the function has ID n + 1; ID 0 is the
+   * entry node, on which the instructions executed unconditionally depend.
+   */
+  typedef DependencyGraph<llvm::Instruction> InstDepGraph;
+
+  /*!
+   * Build the instruction dependency graph of F from its def-use chains, its
+   * memory dependences and its block-level control dependency graph: each
+   * instruction is control dependent on the terminators of the blocks its
+   * own block depends on.
+   */
+  void buildInstructionDependencies(llvm::Function &F,
+                                    const MemoryDependences &Deps,
+                                    const DepGraphView &CDG,
+                                    InstDepGraph &IDG);
+
+  /*!
+   * Collapse IDG to the blocks of F: a link between two instructions becomes
+   * a link between their blocks. Only the kinds whose bit (1 << Kind) is
+   * set in TypeMask are kept. Data links alone give the data dependency
+   * graph, control links alone the control dependency graph, and both the
+   * program dependency graph.
+   */
+  void deriveBlockDependencies(llvm::Function &F, const InstDepGraph &IDG,
+                               DependencyGraph<llvm::BasicBlock> &G,
+                               unsigned TypeMask = ~0U);
+
+  /*!
+   * Instruction Dependency Graph
+   */
+  class InstructionDependencyGraph : public llvm::FunctionPass
+  {
+  public:
+    static char ID; // Pass ID, replacement for typeid
+    InstDepGraph *IDG;
+
+    InstructionDependencyGraph() : llvm::FunctionPass(ID)
+    {
+      IDG = new InstDepGraph();
+    }
+
+    ~InstructionDependencyGraph()
+    {
+      delete IDG;
+    }
+
+    bool runOnFunction(llvm::Function &F);
+
+    void getAnalysisUsage(llvm::AnalysisUsage &AU) const;
+
+    const char *getPassName() const
+    {
+      return "Instruction Dependency Graph";
+    }
+
+    void print(llvm::raw_ostream &OS, const llvm::Module* M = 0) const;
+  };
+}
+
+#endif // INSTRUCTIONDEPENDENCIES_H
@@ -0,0 +1,200 @@
+/** ---*- C++ -*--- LazyDependencies.h
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+
+
+#ifndef LAZYDEPENDENCIES_H
+#define LAZYDEPENDENCIES_H
+
+#include "cot/DependencyGraph/DataDependencies.h"
+#include "cot/DependencyGraph/DependencyGraph.h"
+#include "cot/DependencyGraph/Slicing.h"
+#include "llvm/Pass.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DenseMap.h"
+
+#include <utility>
+#include <vector>
+
+namespace llvm
+{
+  class AliasAnalysis;
+  class Function;
+  class MemoryDependenceAnalysis;
+  template <class NodeT> class DominatorTreeBase;
+}
+
+namespace cot
+{
+  /*!
+   * Program dependency graph of a function whose links are found on demand.
+   * The dependences of a block, the links into it, are computed the first
+   * time a query needs them and kept until the graph is reset:
+   *
+   *  - control links come from the edges into the post-dominator subtree of
+   *    the block;
+   *  - data links come from the operands of its instructions and from MDA
+   *    queries for its stores.
+   *
+   * Node IDs are those of the eager graph: the entry node is 0, and blocks
+   * follow in function order. Backward slices and link queries cost in
+   * proportion to the blocks they visit; forward slices and printing need
+   * the dependences of every block. With -ddg-alias-sets, alias sets are
+   * paired for the whole function the first time memory links are needed.
+   * Memory links are never summarized.
+   */
+  class LazyDependencyGraph
+  {
+  public:
+    /// ID of a node the link comes from, and kinds of the link.
+    typedef std::pair<uint32_t, unsigned> Dependence;
+    typedef std::vector<Dependence> DependenceList;
+
+    LazyDependencyGraph() :
+    mF(0), mPDT(0), mAA(0), mMDA(0), mTypeMask(0), mHasAliasSets(false) { }
+
+    /*!
+     * Start answering queries on F, keeping links with a kind in TypeMask.
+     * The analyses must stay alive and up to date while the graph is used.
+     */
+    void reset(llvm::Function &F,
+               llvm::DominatorTreeBase<llvm::BasicBlock> &PDT,
+               llvm::AliasAnalysis &AA, llvm::MemoryDependenceAnalysis &MDA,
+               unsigned TypeMask = AllTypesMask);
+
+    void clear();
+
+    unsigned getNumNodes() const { return mBlocks.size(); }
+
+    /// Block of node ID, null for the entry node.
+    const llvm::BasicBlock *getBlock(uint32_t ID) const
+    {
+      return mBlocks[ID];
+    }
+
+    /// ID of the node of BB, the entry node if BB is null.
+    uint32_t getID(const llvm::BasicBlock *BB) const
+    {
+      return BB ? mIDs.lookup(BB) : 0;
+    }
+
+    /// Dependences of node ID, sorted by the ID of the node they come from.
+    const DependenceList &getDependences(uint32_t ID);
+
+    /// Kinds of the link from the node From to the node To.
+    unsigned getLinkTypes(uint32_t From, uint32_t To);
+
+    bool depends(const llvm::BasicBlock *pNode1,
+                 const llvm::BasicBlock *pNode2)
+    {
+      return getLinkTypes(getID(pNode1), getID(pNode2));
+    }
+
+    /// Number of nodes whose dependences were computed.
+    unsigned getNumComputed() const { return mComputed.count(); }
+
+    /*!
+     * Slice from the node IDs in [I, E). The result stays valid until the
+     * next call.
+     */
+    template <class IterT>
+    const llvm::BitVector &slice(IterT I, IterT E, SliceDirection Dir)
+    {
+      mSlice.reset();
+      mSlice.resize(getNumNodes());
+      std::vector<uint32_t> Worklist;
+      for (; I != E; ++I)
+        if (!mSlice.test(*I))
+        {
+          mSlice.set(*I);
+          Worklist.push_back(*I);
+        }
+      if (Dir == BackwardSlice)
+        sliceBackward(Worklist);
+      else
+        sliceForward(Worklist);
+      return mSlice;
+    }
+
+    /*!
+     * Fill G with the control links of every node and freeze it. The nodes
+     * not computed yet only have their control links found, with no MDA
+     * query.
+     */
+    void getControlDependencies(DependencyGraph<llvm::BasicBlock> &G);
+
+    /// Print the graph as the eager one is printed, computing every node.
+    void print(llvm::raw_ostream &OS, const char *PN);
+
+  private:
+    LazyDependencyGraph(const LazyDependencyGraph &);
+    void operator=(const LazyDependencyGraph &);
+
+    void computeDependences(uint32_t ID);
+    void addControlDependences(const llvm::BasicBlock *BB,
+                               DependenceList &Deps);
+    void addDataDependences(const llvm::BasicBlock *BB, DependenceList &Deps);
+    void sliceBackward(std::vector<uint32_t> &Worklist);
+    void sliceForward(std::vector<uint32_t> &Worklist);
+
+    /// Links from each node, computing every node.
+    void getLinks(std::vector<DependenceList> &Links);
+
+    llvm::Function *mF;
+    llvm::DominatorTreeBase<llvm::BasicBlock> *mPDT;
+    llvm::AliasAnalysis *mAA;
+    llvm::MemoryDependenceAnalysis *mMDA;
+    unsigned mTypeMask;
+
+    std::vector<const llvm::BasicBlock *> mBlocks;
+    llvm::DenseMap<const llvm::BasicBlock *, uint32_t> mIDs;
+    std::vector<DependenceList> mDependences;
+    llvm::BitVector mComputed;
+    llvm::BitVector mSlice;
+
+    // Memory dependences of each node, with -ddg-alias-sets.
+    std::vector<MemoryDependences> mAliasSetDeps;
+    bool mHasAliasSets;
+  };
+
+  /*!
+   * Lazy Program Dependency Graph. Running it only numbers the blocks of the
+   * function; links are found as clients ask for them.
+   */
+  class LazyProgramDependencyGraph : public llvm::FunctionPass
+  {
+  public:
+    static char ID; // Pass ID, replacement for typeid
+    LazyDependencyGraph LPDG;
+
+    LazyProgramDependencyGraph() : llvm::FunctionPass(ID) { }
+
+    bool runOnFunction(llvm::Function &F);
+
+    void getAnalysisUsage(llvm::AnalysisUsage &AU) const;
+
+    const char *getPassName() const
+    {
+      return "Lazy Program Dependency Graph";
+    }
+
+    void print(llvm::raw_ostream &OS, const llvm::Module* M = 0) const;
+  };
+}
+
+#endif // LAZYDEPENDENCIES_H
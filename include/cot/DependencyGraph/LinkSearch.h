@@ -0,0 +1,147 @@
+/** ---*- C++ -*--- LinkSearch.h
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+
+
+#ifndef LINKSEARCH_H
+#define LINKSEARCH_H
+
+#include "cot/DependencyGraph/DependencyGraph.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/Support/DataTypes.h"
+
+#include <algorithm>
+
+namespace cot
+{
+  /*!
+   * Policies finding a link among the sorted targets of a frozen graph node,
+   * for clients such as DependencyQueries taking one as a template argument.
+   * A policy has:
+   *
+   *  - build(G), called once the graph is frozen, before any search;
+   *  - getLinkTypes(G, From, To, Hint), the kinds of the link from node From
+   *    to node To, 0 if there is none. Hint points into the targets of From,
+   *    at or before To; the search starts there and leaves Hint at the first
+   *    target not less than To, so that searches for increasing targets of
+   *    the same node resume where the last one ended.
+   *
+   * The links themselves stay in the CSR arrays of the graph, which need no
+   * allocation per node; a policy only picks how they are searched, to fit
+   * how many links the nodes have.
+   */
+
+  /// Binary search, for nodes of any degree.
+  class SortedLinkSearch
+  {
+  public:
+    template <class NodeT>
+    void build(const DependencyGraph<NodeT> &) { }
+
+    template <class NodeT>
+    unsigned getLinkTypes(const DependencyGraph<NodeT> &G, uint32_t From,
+                          uint32_t To, const uint32_t *&Hint) const
+    {
+      const uint32_t *E = G.targets_end(From);
+      Hint = std::lower_bound(Hint, E, To);
+      if (Hint == E || *Hint != To)
+        return 0;
+      return G.types_begin(From)[Hint - G.targets_begin(From)];
+    }
+  };
+
+  /*!
+   * Linear scan, for graphs whose nodes have a few links each, such as
+   * control dependency graphs: it costs fewer branches than a binary search
+   * over one to three targets.
+   */
+  class LinearLinkSearch
+  {
+  public:
+    template <class NodeT>
+    void build(const DependencyGraph<NodeT> &) { }
+
+    template <class NodeT>
+    unsigned getLinkTypes(const DependencyGraph<NodeT> &G, uint32_t From,
+                          uint32_t To, const uint32_t *&Hint) const
+    {
+      const uint32_t *E = G.targets_end(From);
+      while (Hint != E && *Hint < To)
+        ++Hint;
+      if (Hint == E || *Hint != To)
+        return 0;
+      return G.types_begin(From)[Hint - G.targets_begin(From)];
+    }
+  };
+
+  /*!
+   * Adjacency bit matrix, for dense graphs: a missing link is found with one
+   * bit test, and only existing ones are searched for their kinds. The
+   * matrix takes one bit per pair of nodes, so it is only built for graphs
+   * of at most MaxNodes nodes, 8 MB of bits; larger graphs are searched as
+   * SortedLinkSearch does.
+   */
+  class BitsetLinkSearch
+  {
+  public:
+    static const uint32_t MaxNodes = 8192;
+
+    BitsetLinkSearch() : mNumNodes(0), mHasMatrix(false) { }
+
+    template <class NodeT>
+    void build(const DependencyGraph<NodeT> &G)
+    {
+      mNumNodes = G.getNumNodes();
+      mHasMatrix = mNumNodes <= MaxNodes;
+      mLinks.clear();
+      if (!mHasMatrix)
+        return;
+      mLinks.resize(unsigned(uint64_t(mNumNodes) * mNumNodes));
+      for (uint32_t From = 0; From != mNumNodes; ++From)
+        for (const uint32_t *T = G.targets_begin(From),
+               *TE = G.targets_end(From); T != TE; ++T)
+          mLinks.set(getIndex(From, *T));
+    }
+
+    template <class NodeT>
+    unsigned getLinkTypes(const DependencyGraph<NodeT> &G, uint32_t From,
+                          uint32_t To, const uint32_t *&Hint) const
+    {
+      assert(mNumNodes == G.getNumNodes() && "Matrix not built!");
+      if (mHasMatrix && !mLinks.test(getIndex(From, To)))
+        return 0;
+      return mSearch.getLinkTypes(G, From, To, Hint);
+    }
+
+    /// Whether build() made a matrix, that is whether the graph was small.
+    bool hasMatrix() const { return mHasMatrix; }
+
+  private:
+    unsigned getIndex(uint32_t From, uint32_t To) const
+    {
+      return unsigned(uint64_t(From) * mNumNodes + To);
+    }
+
+    uint32_t mNumNodes;
+    bool mHasMatrix;
+    llvm::BitVector mLinks;
+    SortedLinkSearch mSearch;
+  };
+}
+
+#endif // LINKSEARCH_H
@@ -0,0 +1,67 @@
+/** ---*- C++ -*--- ParallelDependencies.h
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+
+
+#ifndef PARALLELDEPENDENCIES_H
+#define PARALLELDEPENDENCIES_H
+
+#include "llvm/Pass.h"
+
+#include <string>
+#include <vector>
+
+namespace cot
+{
+  /*!
+   * Module-level driver building the control, data and program dependency
+   * graphs of every function of a module on a work-stealing pool of threads.
+   *
+   * Memory dependence queries are issued serially up front, since neither
+   * MemoryDependenceAnalysis nor AliasAnalysis are thread-safe. Then each
+   * worker computes the post-dominator tree and the graph of the functions
+   * it gets, reusing its own graph from one function to the next; as with
+   * the analyses, the three graphs are views of its control and data layers.
+   * Graphs are printed by the workers, and the output is kept in function
+   * order.
+   */
+  class ParallelDependencyGraphs : public llvm::ModulePass
+  {
+  public:
+    static char ID; // Pass ID, replacement for typeid
+
+    ParallelDependencyGraphs() : llvm::ModulePass(ID) { }
+
+    bool runOnModule(llvm::Module &M);
+
+    void getAnalysisUsage(llvm::AnalysisUsage &AU) const;
+
+    const char *getPassName() const
+    {
+      return "Parallel Dependency Graphs";
+    }
+
+    void print(llvm::raw_ostream &OS, const llvm::Module* M = 0) const;
+
+  private:
+    // Printed graphs, one entry per defined function.
+    std::vector<std::string> mOutput;
+  };
+}
+
+#endif // PARALLELDEPENDENCIES_H
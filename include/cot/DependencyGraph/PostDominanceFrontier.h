@@ -0,0 +1,87 @@
+/** ---*- C++ -*--- PostDominanceFrontier.h
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+
+
+#ifndef POSTDOMINANCEFRONTIER_H
+#define POSTDOMINANCEFRONTIER_H
+
+#include "llvm/Pass.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/Analysis/Dominators.h"
+
+#include <vector>
+
+namespace llvm
+{
+  class BasicBlock;
+  class Function;
+}
+
+namespace cot
+{
+  /*!
+   * Post-Dominance Frontier, also known as reverse dominance frontier. A block
+   * Y is in the frontier of X if X post-dominates a successor of Y but does not
+   * strictly post-dominate Y: that is, X is control dependent on Y.
+   *
+   * Frontiers are computed walking the post-dominator tree upwards from the
+   * successors of each block (Cooper, Harvey and Kennedy), so the cost is
+   * linear in the number of CFG edges plus the size of the frontiers. They are
+   * stored in a single array, grouped by block.
+   */
+  class PostDominanceFrontier : public llvm::FunctionPass
+  {
+  public:
+    static char ID; // Pass ID, replacement for typeid
+
+    typedef llvm::BasicBlock *const *iterator;
+
+    PostDominanceFrontier() : llvm::FunctionPass(ID) { }
+
+    bool runOnFunction(llvm::Function &F);
+
+    void getAnalysisUsage(llvm::AnalysisUsage &AU) const;
+
+    const char *getPassName() const
+    {
+      return "Post-Dominance Frontier";
+    }
+
+    void print(llvm::raw_ostream &OS, const llvm::Module* M = 0) const;
+
+    /// Compute the frontiers of the blocks of F, given its post-dominator tree.
+    void calculate(llvm::Function &F,
+                   llvm::DominatorTreeBase<llvm::BasicBlock> &PDT);
+
+    /// Blocks in the frontier of BB, in function order.
+    iterator frontier_begin(const llvm::BasicBlock *BB) const;
+
+    iterator frontier_end(const llvm::BasicBlock *BB) const;
+
+  private:
+    typedef llvm::DenseMap<const llvm::BasicBlock *, unsigned> BlockIndexMap;
+
+    BlockIndexMap mBlockIdx;
+    std::vector<llvm::BasicBlock *> mBlocks;
+    std::vector<unsigned> mBegin;
+    std::vector<llvm::BasicBlock *> mFrontiers;
+  };
+}
+
+#endif // POSTDOMINANCEFRONTIER_H
@@ -24,28 +24,40 @@
 #include "llvm/Pass.h"
 #include "cot/DependencyGraph/DependencyGraph.h"
 
+namespace llvm
+{
+  class Function;
+  template <class NodeT> class DominatorTreeBase;
+}
+
 namespace cot {
 
+struct MemoryDependences;
+
 typedef DependencyGraph<llvm::BasicBlock> ProgramDepGraph;
 
 /*!
- * Program Dependencies Graph
+ * Build the program dependency graph of F, given its post-dominator tree
+ * and its memory dependences: its control and data links are added to PDG
+ * and frozen together, as the layers the analyses share.
+ */
+void buildProgramDependencies(llvm::Function &F,
+                              llvm::DominatorTreeBase<llvm::BasicBlock> &PDT,
+                              const MemoryDependences &Deps,
+                              ProgramDepGraph &PDG);
+
+/*!
+ * Program Dependencies Graph, the view of both layers of the graph shared
+ * through DependencyLayers. Building it takes no more than requiring the
+ * control and data dependency graphs.
  */
 class ProgramDependencyGraph : public llvm::FunctionPass
 {
 public:
   static char ID; // Pass ID, replacement for typeid
-  ProgramDepGraph *PDG;
-
-  ProgramDependencyGraph() : llvm::FunctionPass(ID)
-  {
-    PDG = new ProgramDepGraph();
-  }
+  DepGraphView PDG;
 
-  ~ProgramDependencyGraph()
-  {
-    delete PDG;
-  }
+  ProgramDependencyGraph() : llvm::FunctionPass(ID) { }
 
   bool runOnFunction(llvm::Function &F);
 
@@ -65,17 +77,18 @@ namespace llvm
 {
 
   template <> struct GraphTraits<cot::ProgramDependencyGraph *>
-      : public GraphTraits<cot::DepGraph*> {
+      : public cot::DependencyViewGraphTraits<cot::ControlTypeMask |
+                                              cot::DataTypeMask> {
     static NodeType *getEntryNode(cot::ProgramDependencyGraph *PG) {
-      return *(PG->PDG->begin_children());
+      return *(PG->PDG.begin_children());
     }
 
     static nodes_iterator nodes_begin(cot::ProgramDependencyGraph *PG) {
-      return PG->PDG->begin_children();
+      return PG->PDG.begin_children();
     }
 
     static nodes_iterator nodes_end(cot::ProgramDependencyGraph *PG) {
-      return PG->PDG->end_children();
+      return PG->PDG.end_children();
     }
   };
 
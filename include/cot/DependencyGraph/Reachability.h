@@ -0,0 +1,199 @@
+/** ---*- C++ -*--- Reachability.h
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef REACHABILITY_H
+#define REACHABILITY_H
+
+#include "cot/DependencyGraph/DependencyGraph.h"
+#include "llvm/Support/DataTypes.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+namespace cot
+{
+  /*!
+   * Reachability index of a frozen dependency graph, answering whether a
+   * node transitively depends on another one.
+   *
+   * It works on the strongly connected components of the graph, as given by
+   * DependencyGraph::getComponents(), and stays valid as long as they do. If
+   * there are at most MaxMatrixComponents of them, the closure of the DAG
+   * is stored as a bit matrix, one row of 64-bit words per component, and
+   * queries take constant time. Larger graphs keep an interval label per
+   * component instead: it rejects most unreachable pairs in constant time,
+   * the others are answered by a search of the DAG pruned by the labels.
+   */
+  template <class NodeT = llvm::BasicBlock>
+  class DependencyReachability
+  {
+  public:
+    static const unsigned DefaultMaxMatrixComponents = 1 << 14;
+
+    explicit DependencyReachability(const DependencyGraph<NodeT> &G,
+                                    unsigned MaxMatrixComponents =
+                                      DefaultMaxMatrixComponents) :
+    mComponents(G.getComponents()), mUseMatrix(false), mNumWords(0),
+    mSearch(0)
+    {
+      mUseMatrix = mComponents.getNumComponents() <= MaxMatrixComponents;
+      if (mUseMatrix)
+        buildClosure();
+      else
+        buildLabels();
+    }
+
+    /*!
+     * Whether there is a path, possibly empty, from node ID From to node ID
+     * To. Answering without the matrix uses scratch state, so concurrent
+     * queries need one index per thread.
+     */
+    bool reaches(uint32_t From, uint32_t To) const
+    {
+      uint32_t A = mComponents.getComponent(From);
+      uint32_t B = mComponents.getComponent(To);
+      // Components are numbered in reverse topological order.
+      if (B > A)
+        return false;
+      if (mUseMatrix)
+        return (mClosure[size_t(A) * mNumWords + B / 64] >> (B % 64)) & 1;
+      return searchDAG(A, B);
+    }
+
+    bool reaches(const DependencyGraph<NodeT> &G, const NodeT *From,
+                 const NodeT *To) const
+    {
+      const DependencyNode<NodeT> *pFrom = G.getNodeByData(From);
+      const DependencyNode<NodeT> *pTo = G.getNodeByData(To);
+      if (!pFrom || !pTo)
+        return false;
+      return reaches(pFrom->getID(), pTo->getID());
+    }
+
+    bool usesMatrix() const { return mUseMatrix; }
+
+    /// Bytes used by the index, not counting the components of the graph.
+    size_t getMemoryUsage() const
+    {
+      return mClosure.capacity() * sizeof(uint64_t) +
+             mMinLabel.capacity() * sizeof(uint32_t) +
+             mVisited.capacity() * sizeof(uint32_t) +
+             mWorklist.capacity() * sizeof(uint32_t);
+    }
+
+  private:
+    /*!
+     * Fill the closure matrix. Successors of a component have lower numbers,
+     * so their rows are complete when it is reached; and a row only has bits
+     * up to its own component, so only that prefix of it has to be merged.
+     */
+    void buildClosure()
+    {
+      uint32_t NumComponents = mComponents.getNumComponents();
+      mNumWords = (NumComponents + 63) / 64;
+      mClosure.assign(size_t(NumComponents) * mNumWords, 0);
+      for (uint32_t C = 0; C != NumComponents; ++C)
+      {
+        uint64_t *Row = &mClosure[size_t(C) * mNumWords];
+        Row[C / 64] |= uint64_t(1) << (C % 64);
+        for (const uint32_t *D = mComponents.dag_begin(C),
+               *DE = mComponents.dag_end(C); D != DE; ++D)
+        {
+          const uint64_t *Succ = &mClosure[size_t(*D) * mNumWords];
+          for (uint32_t W = 0, WE = *D / 64 + 1; W != WE; ++W)
+            Row[W] |= Succ[W];
+        }
+      }
+    }
+
+    /*!
+     * Component numbers are a post-order of a depth-first search; each
+     * component is labelled with the lowest number among its descendants.
+     * A component can only reach components whose number lies within its
+     * label and whose label is nested within its own.
+     */
+    void buildLabels()
+    {
+      uint32_t NumComponents = mComponents.getNumComponents();
+      mMinLabel.resize(NumComponents);
+      for (uint32_t C = 0; C != NumComponents; ++C)
+      {
+        uint32_t Min = C;
+        for (const uint32_t *D = mComponents.dag_begin(C),
+               *DE = mComponents.dag_end(C); D != DE; ++D)
+          Min = std::min(Min, mMinLabel[*D]);
+        mMinLabel[C] = Min;
+      }
+      mVisited.assign(NumComponents, 0);
+    }
+
+    bool mayReach(uint32_t A, uint32_t B) const
+    {
+      return B <= A && mMinLabel[A] <= mMinLabel[B];
+    }
+
+    bool searchDAG(uint32_t A, uint32_t B) const
+    {
+      if (!mayReach(A, B))
+        return false;
+      if (A == B)
+        return true;
+
+      if (++mSearch == 0)
+      {
+        std::fill(mVisited.begin(), mVisited.end(), 0);
+        mSearch = 1;
+      }
+      mWorklist.clear();
+      mWorklist.push_back(A);
+      mVisited[A] = mSearch;
+      while (!mWorklist.empty())
+      {
+        uint32_t C = mWorklist.back();
+        mWorklist.pop_back();
+        for (const uint32_t *D = mComponents.dag_begin(C),
+               *DE = mComponents.dag_end(C); D != DE; ++D)
+        {
+          if (*D == B)
+            return true;
+          if (mVisited[*D] == mSearch || !mayReach(*D, B))
+            continue;
+          mVisited[*D] = mSearch;
+          mWorklist.push_back(*D);
+        }
+      }
+      return false;
+    }
+
+    const DependencyComponents &mComponents;
+
+    // Closure matrix.
+    bool mUseMatrix;
+    uint32_t mNumWords;
+    std::vector<uint64_t> mClosure;
+
+    // Interval labels and search scratch state.
+    std::vector<uint32_t> mMinLabel;
+    mutable std::vector<uint32_t> mVisited;
+    mutable std::vector<uint32_t> mWorklist;
+    mutable uint32_t mSearch;
+  };
+}
+
+#endif // REACHABILITY_H
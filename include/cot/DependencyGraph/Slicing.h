@@ -0,0 +1,173 @@
+/** ---*- C++ -*--- Slicing.h
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef SLICING_H
+#define SLICING_H
+
+#include "cot/DependencyGraph/DependencyGraph.h"
+#include "cot/DependencyGraph/InstructionDependencies.h"
+#include "llvm/Pass.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/StringMap.h"
+
+#include <vector>
+
+namespace llvm
+{
+  class Function;
+  class Value;
+}
+
+namespace cot
+{
+  enum SliceDirection
+  {
+    BackwardSlice,
+    ForwardSlice
+  };
+
+  /*!
+   * Slicer over a frozen dependency graph. A backward slice holds the nodes
+   * the criteria transitively depend on, a forward slice the nodes that
+   * transitively depend on the criteria; both include the criteria. Slices
+   * are bitsets indexed by node ID, computed with a worklist; the bitset and
+   * the worklist are reused, so many slices of the same graph can be taken
+   * without allocating.
+   */
+  template <class NodeT = llvm::BasicBlock>
+  class DependencySlicer
+  {
+  public:
+    explicit DependencySlicer(const DependencyGraph<NodeT> &G) : mGraph(G)
+    {
+      assert(G.isFrozen() && "Graph not frozen!");
+    }
+
+    /*!
+     * Slice from the node IDs in [I, E), following only links having a kind
+     * whose bit (1 << Kind) is set in TypeMask. The result stays valid until
+     * the next call.
+     */
+    template <class IterT>
+    const llvm::BitVector &slice(IterT I, IterT E, SliceDirection Dir,
+                                 unsigned TypeMask = ~0U)
+    {
+      mSlice.reset();
+      mSlice.resize(mGraph.getNumNodes());
+      mWorklist.clear();
+      for (; I != E; ++I)
+        visit(*I);
+
+      while (!mWorklist.empty())
+      {
+        uint32_t ID = mWorklist.back();
+        mWorklist.pop_back();
+
+        const uint32_t *LI, *LE;
+        const uint8_t *TI;
+        if (Dir == BackwardSlice)
+        {
+          LI = mGraph.sources_begin(ID);
+          LE = mGraph.sources_end(ID);
+          TI = mGraph.source_types_begin(ID);
+        }
+        else
+        {
+          LI = mGraph.targets_begin(ID);
+          LE = mGraph.targets_end(ID);
+          TI = mGraph.types_begin(ID);
+        }
+        for (; LI != LE; ++LI, ++TI)
+          if (TypeMask & *TI)
+            visit(*LI);
+      }
+      return mSlice;
+    }
+
+    const llvm::BitVector &backwardSlice(uint32_t ID, unsigned TypeMask = ~0U)
+    {
+      return slice(&ID, &ID + 1, BackwardSlice, TypeMask);
+    }
+
+    const llvm::BitVector &forwardSlice(uint32_t ID, unsigned TypeMask = ~0U)
+    {
+      return slice(&ID, &ID + 1, ForwardSlice, TypeMask);
+    }
+
+  private:
+    void visit(uint32_t ID)
+    {
+      if (mSlice.test(ID))
+        return;
+      mSlice.set(ID);
+      mWorklist.push_back(ID);
+    }
+
+    const DependencyGraph<NodeT> &mGraph;
+    llvm::BitVector mSlice;
+    std::vector<uint32_t> mWorklist;
+  };
+
+  /*!
+   * Map the names of the blocks and instructions of F to their values. Unnamed
+   * values are given the numbers the IR printer shows for them.
+   */
+  void nameValues(llvm::Function &F,
+                  llvm::StringMap<const llvm::Value *> &Names);
+
+  /*!
+   * Slice the program dependency graph of each function from the blocks or
+   * instructions named by -pdg-slice-criterion. Block criteria are sliced on
+   * the block-level graph, or with -pdg-slice-lazy on the lazy one, which
+   * only finds the links of the blocks a backward slice reaches. If an
+   * instruction is named, the slice is taken on the instruction dependency
+   * graph, blocks standing for all of their instructions; its control links
+   * come from the lazy graph with -pdg-slice-lazy.
+   */
+  class ProgramSlicing : public llvm::FunctionPass
+  {
+  public:
+    static char ID; // Pass ID, replacement for typeid
+
+    ProgramSlicing() : llvm::FunctionPass(ID), mFoundCriterion(false) { }
+
+    bool runOnFunction(llvm::Function &F);
+
+    void getAnalysisUsage(llvm::AnalysisUsage &AU) const;
+
+    const char *getPassName() const
+    {
+      return "Program Slicing";
+    }
+
+    void print(llvm::raw_ostream &OS, const llvm::Module* M = 0) const;
+
+  private:
+    /// Values of the last slice, blocks or instructions, in function order.
+    std::vector<const llvm::Value *> mSlice;
+    bool mFoundCriterion;
+
+    /// Instruction graph, kept to reuse its memory across functions.
+    InstDepGraph mIDG;
+
+    /// Control links of the lazy graph, for slicing instructions on it.
+    DependencyGraph<llvm::BasicBlock> mLazyCDG;
+  };
+}
+
+#endif // SLICING_H
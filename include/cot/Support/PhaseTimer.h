@@ -0,0 +1,83 @@
+/** ---*- C++ -*--- PhaseTimer.h
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef COT_SUPPORT_PHASETIMER_H
+#define COT_SUPPORT_PHASETIMER_H
+
+#include "llvm/ADT/StringRef.h"
+#include "llvm/Support/DataTypes.h"
+#include "llvm/Support/Timer.h"
+
+namespace cot
+{
+
+  /// Whether -dg-trace-file was given.
+  bool isTraceEnabled();
+
+  /*!
+   * Create the trace writer, if tracing, on the calling thread. Call it
+   * before starting threads that record TraceEvents, so that they do not
+   * race to create it.
+   */
+  void initializeTrace();
+
+  /*!
+   * An event of the Chrome trace written to -dg-trace-file: the time from its
+   * construction to its destruction, on lane Thread of the trace, tagged with
+   * the function being analysed, if any. Name and Function must outlive the
+   * event. Events can be recorded from any thread once initializeTrace() ran;
+   * without tracing they cost a flag test.
+   */
+  class TraceEvent
+  {
+  public:
+    TraceEvent(llvm::StringRef Name, llvm::StringRef Function,
+               unsigned Thread = 0);
+
+    ~TraceEvent();
+
+  private:
+    TraceEvent(const TraceEvent &);
+    void operator=(const TraceEvent &);
+
+    llvm::StringRef mName;
+    llvm::StringRef mFunction;
+    unsigned mThread;
+    uint64_t mStart;
+    bool mEnabled;
+  };
+
+  /*!
+   * A phase of the analysis of a function, timed under -time-passes in the
+   * "Dependency Graph Construction" group and traced as a TraceEvent. LLVM
+   * timers are not thread-safe: phases belong on the thread running the
+   * pass, workers only record TraceEvents.
+   */
+  class PhaseTimer
+  {
+  public:
+    PhaseTimer(llvm::StringRef Name, llvm::StringRef Function);
+
+  private:
+    llvm::NamedRegionTimer mTimer;
+    TraceEvent mEvent;
+  };
+
+}
+
+#endif // COT_SUPPORT_PHASETIMER_H
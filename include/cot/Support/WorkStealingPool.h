@@ -0,0 +1,56 @@
+/** ---*- C++ -*--- WorkStealingPool.h
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef COT_SUPPORT_WORKSTEALINGPOOL_H
+#define COT_SUPPORT_WORKSTEALINGPOOL_H
+
+namespace cot
+{
+
+  /*!
+   * Runs a batch of independent tasks on a set of worker threads. Each worker
+   * starts with a contiguous range of task indices and, once it runs out of
+   * work, steals tasks from the tail of the other workers' ranges.
+   *
+   * The calling thread acts as worker 0. If LLVM was built without thread
+   * support every task runs on the calling thread.
+   */
+  class WorkStealingPool
+  {
+  public:
+    /// Task body: called once per task index, on the given worker.
+    typedef void (*TaskFn)(void *Context, unsigned Task, unsigned Worker);
+
+    /// A pool of NumWorkers workers; 0 means one per available core.
+    explicit WorkStealingPool(unsigned NumWorkers = 0);
+
+    unsigned getNumWorkers() const { return mNumWorkers; }
+
+    /// Run Fn on every task in [0, NumTasks), returning when all are done.
+    void run(unsigned NumTasks, TaskFn Fn, void *Context);
+
+    /// Number of cores available to the process.
+    static unsigned getNumCores();
+
+  private:
+    unsigned mNumWorkers;
+  };
+
+}
+
+#endif // COT_SUPPORT_WORKSTEALINGPOOL_H
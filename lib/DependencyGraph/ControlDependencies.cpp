@@ -16,12 +16,20 @@
  * along with this program.  If not, see http://www.gnu.org/licenses/.
  */
 
+#define DEBUG_TYPE "cdg"
 #include "cot/DependencyGraph/ControlDependencies.h"
 
 #include "cot/AllPasses.h"
+#include "cot/DependencyGraph/DependencyCache.h"
+#include "cot/DependencyGraph/DependencyLayers.h"
+#include "cot/DependencyGraph/PostDominanceFrontier.h"
+#include "cot/Support/PhaseTimer.h"
+#include "cot/Support/WorkStealingPool.h"
 #include "llvm/Function.h"
 #include "llvm/Instructions.h"
 #include "llvm/Analysis/PostDominators.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/raw_ostream.h"
 
 
@@ -29,53 +37,298 @@ using namespace cot;
 using namespace llvm;
 
 
-char ControlDependencyGraph::ID = 0;
+STATISTIC(NumCDGNodes, "Number of nodes of control dependency graphs");
+STATISTIC(NumCDGEdges, "Number of links of control dependency graphs");
+STATISTIC(NumCFGEdges, "Number of CFG edges inducing control dependences");
 
+static cl::opt<bool>
+UsePostDomFrontier("cdg-use-pdf",
+                   cl::desc("Build the control dependency graph from the "
+                            "post-dominance frontier"),
+                   cl::init(false));
 
-bool ControlDependencyGraph::runOnFunction(Function &F)
+static cl::opt<unsigned>
+NumThreads("cdg-threads",
+           cl::desc("Number of threads computing control dependences "
+                    "(0: one per core)"),
+           cl::init(1));
+
+static cl::opt<unsigned>
+ParallelThreshold("cdg-parallel-threshold",
+                  cl::desc("Minimum number of CFG edges for computing control "
+                           "dependences in parallel"),
+                  cl::init(4096));
+
+
+namespace {
+
+/*!
+ * A CFG edge, or a (controller, dependent) pair it induces, along with the
+ * kinds of the control links it stands for.
+ */
+struct CFGEdge
 {
-  PostDominatorTree &PDT = getAnalysis<PostDominatorTree>();
+  BasicBlock *From;
+  BasicBlock *To;
+  unsigned Kinds;
 
-  /*
-   * The EdgeSet should always contains the Start->EntryNode
-   * edge. This will lead to add every node in the path from the
-   * ExitNode(the immediate postdom of Start) and the EntryNode as
-   * control dependent on Start.
-   */
-  DomTreeNode *entryNode = PDT[&F.getEntryBlock()];
+  CFGEdge(BasicBlock *pFrom, BasicBlock *pTo, unsigned EdgeKinds) :
+  From(pFrom), To(pTo), Kinds(EdgeKinds) { }
+};
+
+typedef std::vector<CFGEdge> CFGEdgeList;
+
+/// Collect the (controller, dependent) pairs induced by a CFG edge.
+void collectDependencies(DominatorTreeBase<BasicBlock> &PDT,
+                         const CFGEdge &Edge,
+                         CFGEdgeList &Deps)
+{
+  BasicBlock *BB = PDT.findNearestCommonDominator(Edge.From, Edge.To);
+
+  DomTreeNode *domNode = PDT.getNode(Edge.To);
+  while (domNode->getBlock() != BB)
+  {
+    Deps.push_back(CFGEdge(Edge.From, domNode->getBlock(), Edge.Kinds));
+    domNode = domNode->getIDom();
+  }
+}
+
+/// The EdgeSet split in contiguous shards, each with its own output buffer.
+struct EdgeShards
+{
+  DominatorTreeBase<BasicBlock> *PDT;
+  const CFGEdgeList *Edges;
+  std::vector<CFGEdgeList> Deps;
+};
+
+void computeShard(void *Context, unsigned Shard, unsigned)
+{
+  EdgeShards &S = *static_cast<EdgeShards *>(Context);
+  size_t NumEdges = S.Edges->size();
+  size_t NumShards = S.Deps.size();
+  for (size_t I = NumEdges * Shard / NumShards,
+         E = NumEdges * (Shard + 1) / NumShards; I != E; ++I)
+    collectDependencies(*S.PDT, (*S.Edges)[I], S.Deps[Shard]);
+}
+
+} // End anonymous namespace.
+
+
+/*!
+ * The EdgeSet should always contains the Start->EntryNode
+ * edge. This will lead to add every node in the path from the
+ * ExitNode(the immediate postdom of Start) and the EntryNode as
+ * control dependent on Start.
+ */
+static void addStartDependencies(Function &F,
+                                 DominatorTreeBase<BasicBlock> &PDT,
+                                 ControlDepGraph &CDG)
+{
+  DomTreeNode *entryNode = PDT.getNode(&F.getEntryBlock());
   while (entryNode && entryNode->getBlock())
   {
     /*
      * Walking the path backward and adding dependencies.
      */
-    CDG->addDependency(static_cast<BasicBlock *>(0),
-                       entryNode->getBlock(), CONTROL);
+    CDG.addDependency(static_cast<BasicBlock *>(0),
+                      entryNode->getBlock(), CONTROL);
     entryNode = entryNode->getIDom();
   }
+}
+
+
+unsigned cot::getEdgeKinds(const TerminatorInst *TI, unsigned Succ)
+{
+  unsigned Kinds = 1U << CONTROL_DEPENDENCE;
+  if (const BranchInst *BI = dyn_cast<BranchInst>(TI))
+  {
+    if (BI->isConditional())
+      Kinds |= 1U << (Succ == 0 ? TRUE_BRANCH : FALSE_BRANCH);
+  }
+  else if (isa<SwitchInst>(TI))
+    Kinds |= 1U << CASE_BRANCH;
+  return Kinds;
+}
 
-  std::vector<std::pair<BasicBlock *, BasicBlock *> > EdgeSet;
+
+static void updateStatistics(const DepGraphView &CDG)
+{
+  NumCDGNodes += CDG.getNumNodes();
+  NumCDGEdges += CDG.getNumEdges();
+}
+
+
+void cot::addControlDependencies(Function &F,
+                                 DominatorTreeBase<BasicBlock> &PDT,
+                                 ControlDepGraph &CDG,
+                                 unsigned NumThreads)
+{
+  CDG.reserve(F.size() + 1);
+
+  addStartDependencies(F, PDT, CDG);
+
+  CFGEdgeList EdgeSet;
   for (Function::iterator I = F.begin(), E = F.end(); I != E; ++I)
   {
-    for (succ_iterator SI = succ_begin(I), SE = succ_end(I); SI != SE; ++SI)
+    TerminatorInst *TI = I->getTerminator();
+    for (unsigned S = 0, SE = TI->getNumSuccessors(); S != SE; ++S)
     {
-      if (!PDT.properlyDominates(*SI, I))
-        EdgeSet.push_back(std::make_pair(I, *SI));
+      BasicBlock *Succ = TI->getSuccessor(S);
+      if (!PDT.properlyDominates(Succ, I))
+        EdgeSet.push_back(CFGEdge(I, Succ, getEdgeKinds(TI, S)));
     }
   }
+  NumCFGEdges += EdgeSet.size();
+
+  if (NumThreads > 1 && EdgeSet.size() >= ParallelThreshold)
+  {
+    /*
+     * Edges are independent, so shards of EdgeSet are processed concurrently.
+     * Dominance queries update DFS numbers lazily, so compute them now in
+     * order to make the tree read-only. Shards are merged in order, giving
+     * the same links the serial loop would add.
+     */
+    PDT.updateDFSNumbers();
+
+    EdgeShards Shards;
+    Shards.PDT = &PDT;
+    Shards.Edges = &EdgeSet;
+    Shards.Deps.resize(NumThreads * 4);
+    WorkStealingPool Pool(NumThreads);
+    Pool.run(Shards.Deps.size(), computeShard, &Shards);
+
+    for (std::vector<CFGEdgeList>::iterator SI = Shards.Deps.begin(),
+           SE = Shards.Deps.end(); SI != SE; ++SI)
+      for (CFGEdgeList::iterator I = SI->begin(), E = SI->end(); I != E; ++I)
+        CDG.addDependencyTypes(I->From, I->To, I->Kinds);
+    return;
+  }
 
-  typedef std::vector<std::pair<BasicBlock *, BasicBlock *> >::iterator EdgeItr;
+  typedef CFGEdgeList::iterator EdgeItr;
   for (EdgeItr I = EdgeSet.begin(), E = EdgeSet.end(); I != E; ++I)
   {
-    std::pair<BasicBlock *, BasicBlock *> Edge = *I;
-    BasicBlock *BB = PDT.findNearestCommonDominator(Edge.first, Edge.second);
+    const CFGEdge &Edge = *I;
+    BasicBlock *BB = PDT.findNearestCommonDominator(Edge.From, Edge.To);
 
-    DomTreeNode *domNode = PDT[Edge.second];
+    DomTreeNode *domNode = PDT.getNode(Edge.To);
     while (domNode->getBlock() != BB)
     {
-      CDG->addDependency(Edge.first, domNode->getBlock(), CONTROL);
+      CDG.addDependencyTypes(Edge.From, domNode->getBlock(), Edge.Kinds);
       domNode = domNode->getIDom();
     }
   }
+}
+
+
+void cot::addBlockControlDependencies(Function &F, BasicBlock *BB,
+                                      DominatorTreeBase<BasicBlock> &PDT,
+                                      ControlDepGraph &CDG)
+{
+  if (!BB)
+  {
+    addStartDependencies(F, PDT, CDG);
+    return;
+  }
+
+  CFGEdgeList Deps;
+  TerminatorInst *TI = BB->getTerminator();
+  for (unsigned S = 0, SE = TI->getNumSuccessors(); S != SE; ++S)
+  {
+    BasicBlock *Succ = TI->getSuccessor(S);
+    if (!PDT.properlyDominates(Succ, BB))
+      collectDependencies(PDT, CFGEdge(BB, Succ, getEdgeKinds(TI, S)), Deps);
+  }
+  for (CFGEdgeList::iterator I = Deps.begin(), E = Deps.end(); I != E; ++I)
+    CDG.addDependencyTypes(I->From, I->To, I->Kinds);
+}
+
+
+void cot::buildControlDependencies(Function &F,
+                                   DominatorTreeBase<BasicBlock> &PDT,
+                                   ControlDepGraph &CDG,
+                                   unsigned NumThreads)
+{
+  CDG.clear();
+  addControlDependencies(F, PDT, CDG, NumThreads);
+  CDG.freeze(F.begin(), F.end());
+  updateStatistics(DepGraphView(CDG, ControlTypeMask));
+}
+
+
+char ControlDependencyGraph::ID = 0;
+
+
+bool ControlDependencyGraph::runOnFunction(Function &F)
+{
+  TraceEvent Trace(getPassName(), F.getName());
+  unsigned Threads = NumThreads ? unsigned(NumThreads)
+                               : WorkStealingPool::getNumCores();
+  DependencyLayers &Layers = getAnalysis<DependencyLayers>();
+  CDG = Layers.getView(ControlTypeMask);
+
+  /*
+   * With the cache, the post-dominator tree is not required from the pass
+   * manager: it is only computed here when the layer has to be built.
+   */
+  if (isGraphCacheEnabled())
+  {
+    if (Layers.loadLayer(F, CONTROL))
+      return false;
+    DominatorTreeBase<BasicBlock> PDT(true);
+    {
+      PhaseTimer Phase("Post-dominator tree", F.getName());
+      PDT.recalculate(F);
+    }
+    {
+      PhaseTimer Phase("Control dependences", F.getName());
+      addControlDependencies(F, PDT, Layers.beginLayer(CONTROL), Threads);
+    }
+    Layers.endLayer(F, CONTROL);
+    updateStatistics(CDG);
+    return false;
+  }
+
+  PostDominatorTree &PDT = getAnalysis<PostDominatorTree>();
+
+  if (UsePostDomFrontier)
+  {
+    PostDominanceFrontier &PDF = getAnalysis<PostDominanceFrontier>();
+    {
+      PhaseTimer Phase("Control dependences", F.getName());
+      ControlDepGraph &G = Layers.beginLayer(CONTROL);
+      G.reserve(F.size() + 1);
+      addStartDependencies(F, *PDT.DT, G);
+
+      /*
+       * A block X is control dependent on each block Y in its post-dominance
+       * frontier, through the edges from Y to the successors X
+       * post-dominates; these give the branch kinds of the link.
+       */
+      for (Function::iterator I = F.begin(), E = F.end(); I != E; ++I)
+      {
+        for (PostDominanceFrontier::iterator FI = PDF.frontier_begin(I),
+               FE = PDF.frontier_end(I); FI != FE; ++FI)
+        {
+          TerminatorInst *TI = (*FI)->getTerminator();
+          unsigned Kinds = 1U << CONTROL_DEPENDENCE;
+          for (unsigned S = 0, SE = TI->getNumSuccessors(); S != SE; ++S)
+            if (PDT.dominates(I, TI->getSuccessor(S)))
+              Kinds |= getEdgeKinds(TI, S);
+          G.addDependencyTypes(*FI, I, Kinds);
+        }
+      }
+    }
+    Layers.endLayer(F, CONTROL);
+    updateStatistics(CDG);
+    return false;
+  }
+
+  {
+    PhaseTimer Phase("Control dependences", F.getName());
+    addControlDependencies(F, *PDT.DT, Layers.beginLayer(CONTROL), Threads);
+  }
+  Layers.endLayer(F, CONTROL);
+  updateStatistics(CDG);
   return false;
 }
 
@@ -83,13 +336,19 @@ bool ControlDependencyGraph::runOnFunction(Function &F)
 void ControlDependencyGraph::getAnalysisUsage(AnalysisUsage &AU) const
 {
   AU.setPreservesAll();
+  AU.addRequiredTransitive<DependencyLayers>();
+  if (isGraphCacheEnabled())
+    return;
   AU.addRequired<PostDominatorTree>();
+  if (UsePostDomFrontier)
+    AU.addRequired<PostDominanceFrontier>();
 }
 
 
 void ControlDependencyGraph::print(raw_ostream &OS, const Module*) const
 {
-  CDG->print(OS, getPassName());
+  PhaseTimer Phase("Printing", StringRef());
+  CDG.print(OS, getPassName());
 }
 
 
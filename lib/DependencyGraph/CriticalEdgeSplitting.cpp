@@ -0,0 +1,132 @@
+/** ---*- C++ -*--- CriticalEdgeSplitting.cpp
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#define DEBUG_TYPE "dg-break-crit-edges"
+#include "cot/DependencyGraph/CriticalEdgeSplitting.h"
+
+#include "cot/AllPasses.h"
+#include "cot/DependencyGraph/ControlDependencies.h"
+#include "cot/DependencyGraph/DataDependencies.h"
+#include "cot/DependencyGraph/DependencyLayers.h"
+#include "cot/DependencyGraph/IncrementalDependencies.h"
+#include "cot/DependencyGraph/ProgramDependencies.h"
+#include "llvm/Function.h"
+#include "llvm/Instructions.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/Dominators.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/MemoryDependenceAnalysis.h"
+#include "llvm/Analysis/PostDominators.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Transforms/Utils/BasicBlockUtils.h"
+
+
+using namespace cot;
+using namespace llvm;
+
+
+STATISTIC(NumSplitEdges, "Number of critical edges split");
+
+
+/// Immediate post-dominator of BB, null if there is none.
+static BasicBlock *getIPDom(DominatorTreeBase<BasicBlock> &PDT, BasicBlock *BB)
+{
+  DomTreeNode *Node = PDT.getNode(BB);
+  return Node && Node->getIDom() ? Node->getIDom()->getBlock() : 0;
+}
+
+
+char CriticalEdgeSplitting::ID = 0;
+
+
+bool CriticalEdgeSplitting::runOnFunction(Function &F)
+{
+  DominatorTreeBase<BasicBlock> &PDT = *getAnalysis<PostDominatorTree>().DT;
+  DependencyUpdater Updater(F, getAnalysis<DependencyLayers>());
+
+  bool Changed = false;
+  for (Function::iterator I = F.begin(), E = F.end(); I != E; ++I)
+  {
+    TerminatorInst *TI = I->getTerminator();
+    if (TI->getNumSuccessors() < 2 || isa<IndirectBrInst>(TI))
+      continue;
+
+    BasicBlock *IPDom = getIPDom(PDT, I);
+    bool Split = false;
+    for (unsigned i = 0, e = TI->getNumSuccessors(); i != e; ++i)
+    {
+      BasicBlock *Dest = TI->getSuccessor(i);
+      BasicBlock *NewBB = SplitCriticalEdge(TI, i, this);
+      if (!NewBB)
+        continue;
+      ++NumSplitEdges;
+      Split = true;
+
+      // Blocks that cannot reach an exit are not in the tree.
+      if (PDT.getNode(Dest))
+        PDT.splitBlock(NewBB);
+      Updater.blockInserted(NewBB);
+      // The PHI nodes of Dest now take their value from NewBB.
+      Updater.instructionsChanged(Dest);
+    }
+
+    if (!Split)
+      continue;
+    Changed = true;
+    Updater.successorsChanged(I);
+    if (getIPDom(PDT, I) != IPDom)
+      Updater.postDominatorChanged(I);
+  }
+
+  // Memory dependence queries walk the predecessors it cached before.
+  MemoryDependenceAnalysis &MDA = getAnalysis<MemoryDependenceAnalysis>();
+  if (Changed)
+    MDA.invalidateCachedPredecessors();
+
+  Updater.update(&PDT, &getAnalysis<AliasAnalysis>(), &MDA);
+  return Changed;
+}
+
+
+void CriticalEdgeSplitting::getAnalysisUsage(AnalysisUsage &AU) const
+{
+  AU.addRequired<DependencyLayers>();
+  AU.addRequired<PostDominatorTree>();
+  AU.addRequired<AliasAnalysis>();
+  AU.addRequired<MemoryDependenceAnalysis>();
+
+  AU.addPreserved<DependencyLayers>();
+  AU.addPreserved<ControlDependencyGraph>();
+  AU.addPreserved<DataDependencyGraph>();
+  AU.addPreserved<ProgramDependencyGraph>();
+  AU.addPreserved<PostDominatorTree>();
+  AU.addPreserved<DominatorTree>();
+  AU.addPreserved<LoopInfo>();
+}
+
+
+CriticalEdgeSplitting *cot::CreateCriticalEdgeSplittingPass()
+{
+  return new CriticalEdgeSplitting();
+}
+
+
+INITIALIZE_PASS(CriticalEdgeSplitting, "dg-break-crit-edges",
+                "Break critical edges, updating dependency graphs",
+                false,
+                false)
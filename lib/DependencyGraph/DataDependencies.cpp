@@ -16,79 +16,491 @@
  * along with this program.  If not, see http://www.gnu.org/licenses/.
  */
 
+#define DEBUG_TYPE "ddg"
 #include "cot/DependencyGraph/DataDependencies.h"
 
 #include "cot/AllPasses.h"
+#include "cot/DependencyGraph/DependencyLayers.h"
+#include "cot/Support/PhaseTimer.h"
 #include "llvm/Support/raw_ostream.h"
 #include "llvm/Function.h"
+#include "llvm/Instructions.h"
 #include "llvm/Type.h"
 #include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/AliasSetTracker.h"
 #include "llvm/Analysis/MemoryDependenceAnalysis.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SmallPtrSet.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/CallSite.h"
+#include "llvm/Support/CommandLine.h"
 
 using namespace cot;
 using namespace llvm;
 
 
-char DataDependencyGraph::ID = 0;
+STATISTIC(NumDDGNodes, "Number of nodes of data dependency graphs");
+STATISTIC(NumDDGEdges, "Number of links of data dependency graphs");
+STATISTIC(NumMemoryLinks, "Number of memory dependences found");
+STATISTIC(NumConservativeLinks,
+          "Number of memory dependences only known to be possible");
+STATISTIC(NumStoreQueries, "Number of MDA queries for stores");
+STATISTIC(NumNonLocalQueries, "Number of non-local MDA pointer queries");
+STATISTIC(NumDefResults, "Number of MDA results defining the location");
+STATISTIC(NumClobberResults, "Number of MDA results clobbering the location");
+STATISTIC(NumNonLocalResults, "Number of MDA results outside the block");
+STATISTIC(NumNonFuncLocalResults,
+          "Number of MDA results outside the function");
+STATISTIC(NumUnknownResults, "Number of MDA results without a dependence");
+STATISTIC(NumSummarizedBlocks,
+          "Number of blocks whose memory links were summarized");
 
-bool DataDependencyGraph::runOnFunction(llvm::Function &F)
+static cl::opt<bool>
+UseAliasSets("ddg-alias-sets",
+             cl::desc("Pair the memory accesses of each alias set instead "
+                      "of querying memory dependences of stores"),
+             cl::init(false));
+
+static cl::opt<unsigned>
+MemoryLinkBudget("ddg-memory-link-budget",
+                 cl::desc("Link the memory dependences of blocks depending on "
+                          "more blocks than this through a summary node "
+                          "(default: no limit)"),
+                 cl::init(0));
+
+
+namespace
 {
-   //AliasAnalysis &AA = getAnalysis<AliasAnalysis>();
-   MemoryDependenceAnalysis& MDA = getAnalysis<MemoryDependenceAnalysis>();
-   
-   for (Function::BasicBlockListType::iterator it = F.getBasicBlockList().begin();
-      it != F.getBasicBlockList().end(); ++it) {
-      // Make sure there exists a node for each BB:
-      DDG->getNodeByData(&*it);
-      
-      for (BasicBlock::iterator iit = it->begin(); iit != it->end(); ++iit ) {
-         Instruction *pInstruction = dyn_cast<Instruction>(&*iit);
-         if (isa<StoreInst>(pInstruction)) {
-            MemDepResult res = MDA.getDependency(pInstruction);
-            
-            if (res.isDef()) {
-               // There's a depenency with res.getInst()
-               DDG->addDependency(&*it, res.getInst()->getParent(), DATA);
-            } else if (res.isClobber()) {
-               // There might be a dependency with res.getInst(). Let's be
-               // conservative.
-               DDG->addDependency(&*it, res.getInst()->getParent(), DATA);
-            } else {
-               if (res.isUnknown()) {
-                  // No dependencies found.
-               } else if (res.isNonFuncLocal()) {
-                  // There might be some dependencies with extern instructions,
-                  // but we do not care of this eventuality.
-               } else if (res.isNonLocal()) {
-                  // No dependency found in pInstruction's basic block, but there
-                  // might be in others. To be conservative, we'll add a dependency
-                  // with all the other basic blocks thSat contain an instruction
-                  // that accesses memory.
-                  for (Function::BasicBlockListType::iterator it2 =
-                  F.getBasicBlockList().begin(); it != F.getBasicBlockList().end();
-                  ++it2) {
-                     if (&*it2 != &*it)
-                        for (BasicBlock::iterator iit2 = it2->begin();
-                        iit2 != it2->end(); ++iit2) {
-                           if (iit2->mayReadOrWriteMemory())
-                              DDG->addDependency(&*it, &*it2, DATA);
-                        }
-                  }
-               } 
+   /*!
+    * Adds the memory links of a dependent block to Deps as they are found.
+    * Once they come from more blocks than the budget of Deps, the links of
+    * the block found so far go to the summary, and so do the next ones.
+    */
+   class BlockLinks
+   {
+   public:
+      explicit BlockLinks(MemoryDependences &Deps) :
+      mDeps(Deps), mBB(0), mBegin(0), mSummarized(false) { }
+
+      /// Start the links of BB, which must follow those of the last block.
+      void start(const BasicBlock *BB)
+      {
+         mBB = BB;
+         mBegin = mDeps.Links.size();
+         mDependencies.clear();
+         mSummarized = false;
+      }
+
+      /// Record that I, an instruction of the current block, depends on Dep.
+      void add(const Instruction *I, const Instruction *Dep)
+      {
+         ++NumMemoryLinks;
+         const BasicBlock *DepBB = Dep->getParent();
+         // Self-loops are dropped anyway; they must not count.
+         if (!mSummarized && mDeps.Budget && DepBB != mBB &&
+             mDependencies.insert(DepBB) &&
+             mDependencies.size() > mDeps.Budget) {
+            ++NumSummarizedBlocks;
+            mSummarized = true;
+            for (size_t L = mBegin, E = mDeps.Links.size(); L != E; ++L)
+               summarize(mDeps.Links[L].first, mDeps.Links[L].second);
+            mDeps.Links.resize(mBegin);
+         }
+
+         if (mSummarized)
+            summarize(I, Dep);
+         else
+            mDeps.Links.push_back(std::make_pair(I, Dep));
+      }
+
+   private:
+      void summarize(const Instruction *I, const Instruction *Dep)
+      {
+         if (Dep->getParent() == mBB)
+            return;
+         unsigned Kinds = getMemoryDependenceKinds(I, Dep);
+         mDeps.ToMemoryState[Dep->getParent()] |= Kinds;
+         mDeps.FromMemoryState[mBB] |= Kinds;
+      }
+
+      MemoryDependences &mDeps;
+      const BasicBlock *mBB;
+      size_t mBegin;
+      bool mSummarized;
+      SmallPtrSet<const BasicBlock *, 8> mDependencies;
+   };
+}
+
+
+/*!
+ * Record the link implied by a dependence found by MDA: the defining or
+ * clobbering instruction is a dependency of I.
+ */
+static void addMemoryLink(const Instruction *I, MemDepResult Res,
+                          BlockLinks &Links)
+{
+   if (Res.isDef()) {
+      // There's a depenency with Res.getInst()
+      ++NumDefResults;
+      Links.add(I, Res.getInst());
+   } else if (Res.isClobber()) {
+      // There might be a dependency with Res.getInst(). Let's be
+      // conservative.
+      ++NumClobberResults;
+      ++NumConservativeLinks;
+      Links.add(I, Res.getInst());
+   }
+}
+
+
+/*!
+ * Link I to every other instruction of its function that may read or write
+ * memory, for a dependence MDA could not locate.
+ */
+static void addConservativeLinks(const Instruction *I, BlockLinks &Links)
+{
+   const Function *F = I->getParent()->getParent();
+   for (Function::const_iterator it = F->begin(); it != F->end(); ++it)
+      for (BasicBlock::const_iterator iit = it->begin(); iit != it->end();
+           ++iit)
+         if (&*iit != I && iit->mayReadOrWriteMemory()) {
+            ++NumConservativeLinks;
+            Links.add(I, &*iit);
+         }
+}
+
+
+void cot::collectBlockStoreDependences(BasicBlock &BB, AliasAnalysis &AA,
+                                       MemoryDependenceAnalysis &MDA,
+                                       MemoryDependences &Deps)
+{
+   SmallVector<NonLocalDepResult, 16> NonLocalDeps;
+   BlockLinks Links(Deps);
+   Links.start(&BB);
+
+   for (BasicBlock::iterator iit = BB.begin(); iit != BB.end(); ++iit ) {
+      StoreInst *pStore = dyn_cast<StoreInst>(&*iit);
+      if (!pStore)
+         continue;
+
+      MemDepResult res = MDA.getDependency(pStore);
+      ++NumStoreQueries;
+
+      if (res.isDef() || res.isClobber()) {
+         addMemoryLink(pStore, res, Links);
+      } else if (res.isUnknown()) {
+         // No dependencies found.
+         ++NumUnknownResults;
+      } else if (res.isNonFuncLocal()) {
+         // There might be some dependencies with extern instructions,
+         // but we do not care of this eventuality.
+         ++NumNonFuncLocalResults;
+      } else if (res.isNonLocal()) {
+         // No dependency found in pStore's basic block, but there might
+         // be in others. Ask MDA which blocks actually define or clobber
+         // the stored location.
+         ++NumNonLocalResults;
+         ++NumNonLocalQueries;
+         NonLocalDeps.clear();
+         MDA.getNonLocalPointerDependency(AA.getLocation(pStore), false,
+                                          &BB, NonLocalDeps);
+         bool Unknown = false;
+         for (SmallVectorImpl<NonLocalDepResult>::const_iterator
+              I = NonLocalDeps.begin(), E = NonLocalDeps.end(); I != E; ++I)
+            if (I->getResult().isUnknown()) {
+               ++NumUnknownResults;
+               Unknown = true;
             }
+
+         if (Unknown) {
+            // MDA gave up on some path, e.g. when it could not translate
+            // the pointer into a predecessor. Any access may be a
+            // dependency.
+            addConservativeLinks(pStore, Links);
+            continue;
          }
-         
-         // Data dependency between temporaries. It's easy to detect a DD between
-         // temporaries because LLVM uses the SSA form. So in orderd to detect a DD,
-         // it suffices to find all operands in an instruction of a basic block and
-         // add a dependency between that basic block and the one which contains
-         // the instruction that defines the operand.      
+
+         for (SmallVectorImpl<NonLocalDepResult>::const_iterator
+              I = NonLocalDeps.begin(), E = NonLocalDeps.end(); I != E; ++I)
+            addMemoryLink(pStore, I->getResult(), Links);
+      }
+   }
+}
+
+
+/*!
+ * Query MDA for the dependences of every store of F.
+ */
+static void collectStoreDependences(Function &F, AliasAnalysis &AA,
+                                    MemoryDependenceAnalysis &MDA,
+                                    MemoryDependences &Deps)
+{
+   Deps.clear();
+   for (Function::iterator it = F.begin(); it != F.end(); ++it)
+      collectBlockStoreDependences(*it, AA, MDA, Deps);
+}
+
+
+namespace
+{
+   /*!
+    * The instructions accessing the locations of one alias set, in function
+    * order, each with a flag telling whether it may write them.
+    */
+   struct AliasSetAccesses
+   {
+      std::vector<const Instruction *> Accesses;
+      std::vector<bool> Writes;
+
+      void add(const Instruction *I, bool Write)
+      {
+         Accesses.push_back(I);
+         Writes.push_back(Write);
+      }
+   };
+}
+
+
+/*!
+ * Return the index in PointerSets of the alias set holding the locations
+ * accessed by I, or -1 if I may access memory none of its pointers lead to.
+ */
+static int findAliasSet(const DenseMap<const Value *, unsigned> &PointerSets,
+                        AliasAnalysis &AA, const Instruction *I)
+{
+   const Value *Ptr = 0;
+   if (const LoadInst *LI = dyn_cast<LoadInst>(I))
+      Ptr = LI->getPointerOperand();
+   else if (const StoreInst *SI = dyn_cast<StoreInst>(I))
+      Ptr = SI->getPointerOperand();
+   else if (const VAArgInst *VI = dyn_cast<VAArgInst>(I))
+      Ptr = VI->getPointerOperand();
+   else if (const AtomicRMWInst *RMW = dyn_cast<AtomicRMWInst>(I))
+      Ptr = RMW->getPointerOperand();
+   else if (const AtomicCmpXchgInst *CX = dyn_cast<AtomicCmpXchgInst>(I))
+      Ptr = CX->getPointerOperand();
+   else {
+      ImmutableCallSite CS(I);
+      if (!CS || !AA.onlyAccessesArgPointees(AA.getModRefBehavior(CS)))
+         return -1;
+
+      // The tracker merged the call with the set of each pointer argument
+      // it was given, so any of them leads to its set.
+      for (ImmutableCallSite::arg_iterator A = CS.arg_begin(),
+           AE = CS.arg_end(); A != AE; ++A) {
+         DenseMap<const Value *, unsigned>::const_iterator S =
+            PointerSets.find(*A);
+         if (S != PointerSets.end())
+            return S->second;
+      }
+      return -1;
+   }
+
+   DenseMap<const Value *, unsigned>::const_iterator S = PointerSets.find(Ptr);
+   return S == PointerSets.end() ? -1 : int(S->second);
+}
+
+
+/*!
+ * Link I, which may write memory if Write is set, with the other accesses
+ * of S when at least one of the two may write.
+ */
+static void addAccessLinks(const Instruction *I, bool Write,
+                           const AliasSetAccesses &S, BlockLinks &Links)
+{
+   for (unsigned j = 0, e = S.Accesses.size(); j != e; ++j)
+      if (S.Accesses[j] != I && (Write || S.Writes[j])) {
+         // Sharing an alias set only means the accesses may alias.
+         ++NumConservativeLinks;
+         Links.add(I, S.Accesses[j]);
+      }
+}
+
+
+void cot::collectAliasSetDependences(Function &F, AliasAnalysis &AA,
+                                     MemoryDependences &Deps)
+{
+   Deps.clear();
+
+   AliasSetTracker AST(AA);
+   for (Function::iterator it = F.begin(); it != F.end(); ++it)
+      AST.add(*it);
+
+   // Walk the sets once to learn the set of each pointer.
+   DenseMap<const Value *, unsigned> PointerSets;
+   std::vector<AliasSetAccesses> Sets;
+   for (AliasSetTracker::iterator AS = AST.begin(), E = AST.end(); AS != E;
+        ++AS) {
+      if (AS->isForwardingAliasSet())
+         continue;
+      for (AliasSet::iterator P = AS->begin(), PE = AS->end(); P != PE; ++P)
+         PointerSets[P.getPointer()] = Sets.size();
+      Sets.push_back(AliasSetAccesses());
+   }
+
+   // Partition the memory accesses by alias set. The accesses whose set is
+   // not known, as calls that may touch any memory, go to a catch-all set
+   // that may alias every access.
+   AliasSetAccesses All, CatchAll;
+   std::vector<int> SetOf;
+   for (Function::iterator it = F.begin(); it != F.end(); ++it)
+      for (BasicBlock::iterator iit = it->begin(); iit != it->end(); ++iit) {
+         if (!iit->mayReadOrWriteMemory())
+            continue;
+
+         bool Write = iit->mayWriteToMemory();
+         All.add(&*iit, Write);
+         int AS = findAliasSet(PointerSets, AA, &*iit);
+         SetOf.push_back(AS);
+         if (AS < 0)
+            CatchAll.add(&*iit, Write);
+         else
+            Sets[AS].add(&*iit, Write);
+      }
+
+   // Each access is linked with the others of its set and with the
+   // catch-all ones; a catch-all access is linked with every other one.
+   // Execution order is not tracked, so a pair is linked both ways: this
+   // covers RAW, WAR and WAW dependences alike, loop-carried ones included.
+   // Accesses are visited in function order, so the links of a block are
+   // added together, under the budget.
+   BlockLinks Links(Deps);
+   for (unsigned i = 0, e = All.Accesses.size(); i != e; ++i) {
+      const Instruction *I = All.Accesses[i];
+      if (i == 0 || I->getParent() != All.Accesses[i - 1]->getParent())
+         Links.start(I->getParent());
+
+      if (SetOf[i] < 0) {
+         addAccessLinks(I, All.Writes[i], All, Links);
+      } else {
+         addAccessLinks(I, All.Writes[i], Sets[SetOf[i]], Links);
+         addAccessLinks(I, All.Writes[i], CatchAll, Links);
+      }
+   }
+}
+
+
+bool cot::usesAliasSetDependences()
+{
+   return UseAliasSets;
+}
+
+
+unsigned cot::getMemoryLinkBudget()
+{
+   return MemoryLinkBudget;
+}
+
+
+void cot::collectMemoryDependences(Function &F, AliasAnalysis &AA,
+                                   MemoryDependenceAnalysis &MDA,
+                                   MemoryDependences &Deps)
+{
+   if (UseAliasSets)
+      collectAliasSetDependences(F, AA, Deps);
+   else
+      collectStoreDependences(F, AA, MDA, Deps);
+}
+
+
+unsigned cot::getMemoryDependenceKinds(const Instruction *I,
+                                       const Instruction *Dep)
+{
+   unsigned Kinds = 1U << MEMORY_DEPENDENCE;
+   if (Dep->mayWriteToMemory()) {
+      if (I->mayReadFromMemory())
+         Kinds |= 1U << FLOW_DEPENDENCE;
+      if (I->mayWriteToMemory())
+         Kinds |= 1U << OUTPUT_DEPENDENCE;
+   }
+   if (Dep->mayReadFromMemory() && I->mayWriteToMemory())
+      Kinds |= 1U << ANTI_DEPENDENCE;
+   return Kinds;
+}
+
+
+static void updateStatistics(const DepGraphView &DDG)
+{
+   NumDDGNodes += DDG.getNumNodes();
+   NumDDGEdges += DDG.getNumEdges();
+}
+
+
+void cot::addDataDependencies(Function &F, const MemoryDependences &Deps,
+                              DataDepGraph &DDG)
+{
+   DDG.reserve(F.size());
+
+   for (Function::iterator it = F.begin(); it != F.end(); ++it) {
+      // Make sure there exists a node for each BB:
+      DDG.addNode(&*it);
+
+      // Data dependency between temporaries. It's easy to detect a DD between
+      // temporaries because LLVM uses the SSA form. So in orderd to detect a DD,
+      // it suffices to find all operands in an instruction of a basic block and
+      // add a dependency between that basic block and the one which contains
+      // the instruction that defines the operand.
+      for (BasicBlock::iterator iit = it->begin(); iit != it->end(); ++iit )
          for (Instruction::const_op_iterator cuit = iit->op_begin();
             cuit != iit->op_end(); ++cuit)
             if(Instruction* pInstruction = dyn_cast<Instruction>(*cuit))
-               DDG->addDependency(pInstruction->getParent(), &*it, DATA);
-      }
+               DDG.addDependency(pInstruction->getParent(), &*it, DATA);
+   }
+
+   // Like the ones between temporaries, memory links go from the dependency
+   // to the dependent block.
+   for (std::vector<MemoryDependences::Link>::const_iterator
+        I = Deps.Links.begin(), E = Deps.Links.end(); I != E; ++I)
+      DDG.addDependencyTypes(I->second->getParent(), I->first->getParent(),
+                             getMemoryDependenceKinds(I->first, I->second));
+
+   // Summarized ones go through the memory state node.
+   const BasicBlock *MemoryState = getMemoryStateData<BasicBlock>();
+   typedef DenseMap<const BasicBlock *, unsigned>::const_iterator KindsItr;
+   for (KindsItr I = Deps.ToMemoryState.begin(), E = Deps.ToMemoryState.end();
+        I != E; ++I)
+      DDG.addDependencyTypes(I->first, MemoryState, I->second);
+   for (KindsItr I = Deps.FromMemoryState.begin(),
+        E = Deps.FromMemoryState.end(); I != E; ++I)
+      DDG.addDependencyTypes(MemoryState, I->first, I->second);
+}
+
+
+void cot::buildDataDependencies(Function &F, const MemoryDependences &Deps,
+                                DataDepGraph &DDG)
+{
+   DDG.clear();
+   addDataDependencies(F, Deps, DDG);
+   DDG.freeze(F.begin(), F.end());
+   updateStatistics(DepGraphView(DDG, DataTypeMask));
+}
+
+
+char DataDependencyGraph::ID = 0;
+
+bool DataDependencyGraph::runOnFunction(llvm::Function &F)
+{
+   TraceEvent Trace(getPassName(), F.getName());
+   DependencyLayers &Layers = getAnalysis<DependencyLayers>();
+   DDG = Layers.getView(DataTypeMask);
+   if (Layers.loadLayer(F, DATA))
+      return false;
+
+   AliasAnalysis &AA = getAnalysis<AliasAnalysis>();
+   MemoryDependenceAnalysis& MDA = getAnalysis<MemoryDependenceAnalysis>();
+
+   MemoryDependences Deps(MemoryLinkBudget);
+   {
+      PhaseTimer Phase("Memory dependences", F.getName());
+      collectMemoryDependences(F, AA, MDA, Deps);
+   }
+   {
+      PhaseTimer Phase("Data dependences", F.getName());
+      addDataDependencies(F, Deps, Layers.beginLayer(DATA));
    }
+   Layers.endLayer(F, DATA);
+   updateStatistics(DDG);
    return false;
 }
 
@@ -97,13 +509,15 @@ void DataDependencyGraph::getAnalysisUsage(AnalysisUsage &AU) const
 {
    AU.addRequiredTransitive<AliasAnalysis>();
    AU.addRequiredTransitive<MemoryDependenceAnalysis>();
+   AU.addRequiredTransitive<DependencyLayers>();
    AU.setPreservesAll();
 }
 
 
 void DataDependencyGraph::print(raw_ostream &OS, const Module*) const
 {
-  DDG->print(OS, getPassName());
+  PhaseTimer Phase("Printing", StringRef());
+  DDG.print(OS, getPassName());
 }
 
 
@@ -29,6 +29,23 @@ using namespace llvm;
 using namespace cot;
 
 
+/*!
+ * Label of a control link, telling the branch edges inducing it: T and F
+ * for a conditional branch, C for a switch.
+ */
+static std::string getBranchLabel(const DependencyViewIterator<> &EI)
+{
+  std::string Label;
+  if (EI.hasKind(TRUE_BRANCH))
+    Label += 'T';
+  if (EI.hasKind(FALSE_BRANCH))
+    Label += 'F';
+  if (EI.hasKind(CASE_BRANCH))
+    Label += 'C';
+  return Label.empty() ? Label : "label=" + Label;
+}
+
+
 namespace llvm {
 
 template <>
@@ -42,6 +59,8 @@ struct DOTGraphTraits<cot::DepGraphNode *> : public DefaultDOTGraphTraits {
 
     if (!BB) return "<<EntryNode>>";
 
+    if (BB == getMemoryStateData<BasicBlock>()) return "<<MemoryState>>";
+
     if (isSimple())
       return DOTGraphTraits<const Function *>
           ::getSimpleNodeLabel(BB, BB->getParent());
@@ -81,8 +100,8 @@ struct DOTGraphTraits<cot::DataDependencyGraph *>
   std::string getNodeLabel(cot::DepGraphNode *Node,
                            cot::DataDependencyGraph *Graph)
   {
-    return DOTGraphTraits<DepGraph *>
-        ::getNodeLabel(Node, Graph->DDG);
+    return DOTGraphTraits<DepGraphNode *>
+        ::getNodeLabel(Node, *(Graph->DDG.begin_children()));
   }
 };
 
@@ -102,8 +121,15 @@ struct DOTGraphTraits<cot::ControlDependencyGraph *>
   std::string getNodeLabel(cot::DepGraphNode *Node,
                            cot::ControlDependencyGraph *Graph)
   {
-    return DOTGraphTraits<DepGraph *>
-        ::getNodeLabel(Node, Graph->CDG);
+    return DOTGraphTraits<DepGraphNode *>
+        ::getNodeLabel(Node, *(Graph->CDG.begin_children()));
+  }
+
+  std::string getEdgeAttributes(cot::DepGraphNode *Node,
+                                cot::DependencyViewIterator<> &EI,
+                                cot::ControlDependencyGraph *CD)
+  {
+    return getBranchLabel(EI);
   }
 };
 
@@ -123,16 +149,20 @@ struct DOTGraphTraits<cot::ProgramDependencyGraph *>
   std::string getNodeLabel(cot::DepGraphNode *Node,
                            cot::ProgramDependencyGraph *Graph)
   {
-    return DOTGraphTraits<DepGraph *>
-        ::getNodeLabel(Node, Graph->PDG);
+    return DOTGraphTraits<DepGraphNode *>
+        ::getNodeLabel(Node, *(Graph->PDG.begin_children()));
   }
 
+  /// Control links are dotted, links of both types dashed.
   std::string getEdgeAttributes(cot::DepGraphNode *Node,
-                                cot::DependencyLinkIterator<> &EI,
+                                cot::DependencyViewIterator<> &EI,
                                 cot::ProgramDependencyGraph *PD)
   {
-    return EI.getDependencyType() == CONTROL ?
-        "style=dotted" : "";
+    if (!EI.hasType(CONTROL))
+      return "";
+    std::string Label = getBranchLabel(EI);
+    return (EI.hasType(DATA) ? "style=dashed" : "style=dotted") +
+           (Label.empty() ? Label : "," + Label);
   }
 };
 }
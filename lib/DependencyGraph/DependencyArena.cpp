@@ -0,0 +1,69 @@
+/** ---*- C++ -*--- DependencyArena.cpp
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "cot/DependencyGraph/DependencyArena.h"
+
+#include "llvm/Support/ErrorHandling.h"
+
+#include <cstdlib>
+
+using namespace cot;
+using namespace llvm;
+
+
+RecyclingSlabAllocator::~RecyclingSlabAllocator()
+{
+  while (mFreeSlabs)
+  {
+    MemSlab *Slab = mFreeSlabs;
+    mFreeSlabs = Slab->NextPtr;
+    std::free(Slab);
+  }
+}
+
+
+MemSlab *RecyclingSlabAllocator::Allocate(size_t Size)
+{
+  // First fit: slabs are almost always of the default size, so the list is
+  // short and the first free slab usually fits.
+  for (MemSlab **Link = &mFreeSlabs; *Link; Link = &(*Link)->NextPtr)
+  {
+    MemSlab *Slab = *Link;
+    if (Slab->Size >= Size)
+    {
+      *Link = Slab->NextPtr;
+      Slab->NextPtr = 0;
+      return Slab;
+    }
+  }
+
+  MemSlab *Slab = static_cast<MemSlab *>(std::malloc(Size));
+  if (!Slab)
+    report_fatal_error("Out of memory while building a dependency graph");
+  Slab->Size = Size;
+  Slab->NextPtr = 0;
+  mBytes += Size;
+  return Slab;
+}
+
+
+void RecyclingSlabAllocator::Deallocate(MemSlab *Slab)
+{
+  Slab->NextPtr = mFreeSlabs;
+  mFreeSlabs = Slab;
+}
@@ -0,0 +1,373 @@
+/** ---*- C++ -*--- DependencyCache.cpp
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#define DEBUG_TYPE "dg-cache"
+#include "cot/DependencyGraph/DependencyCache.h"
+
+#include "cot/DependencyGraph/DataDependencies.h"
+#include "llvm/Function.h"
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Support/system_error.h"
+
+#include <cstring>
+#include <vector>
+
+
+using namespace cot;
+using namespace llvm;
+
+
+STATISTIC(NumCacheHits, "Number of dependency graphs loaded from the cache");
+STATISTIC(NumCacheMisses, "Number of dependency graphs missing in the cache");
+STATISTIC(NumCacheStores, "Number of dependency graphs stored in the cache");
+
+static cl::opt<std::string>
+CacheDir("dg-cache-dir",
+         cl::desc("Directory caching dependency graphs across runs"),
+         cl::value_desc("directory"), cl::init(""));
+
+static cl::opt<std::string>
+CacheSalt("dg-cache-salt",
+          cl::desc("Extra key of the dependency graph cache, telling apart "
+                   "runs whose graphs may differ for the same IR"),
+          cl::init(""));
+
+
+namespace
+{
+  const char CacheMagic[8] = { 'C', 'O', 'T', 'D', 'G', 'R', 'P', 'H' };
+  const uint32_t CacheEndian = 0x01020304;
+  const uint32_t CacheVersion = 4;
+  const uint32_t EntryBlock = ~0U;
+  const uint32_t MemoryStateBlock = ~1U;
+
+  /*!
+   * Layout of a cache file: this header, then the arrays
+   *
+   *   NodeBlocks  uint32_t[NumNodes]      index of the block of each node
+   *   EdgeBegin   uint32_t[NumNodes + 1]
+   *   EdgeTargets uint32_t[NumEdges]
+   *   PredBegin   uint32_t[NumNodes + 1]
+   *   PredSources uint32_t[NumEdges]
+   *   EdgeTypes   uint8_t[NumEdges]
+   *   PredTypes   uint8_t[NumEdges]
+   *
+   * in host byte order. The header size is a multiple of 8, so the arrays
+   * are aligned whenever the file is.
+   */
+  struct CacheHeader
+  {
+    char Magic[8];
+    uint32_t Endian;
+    uint32_t Version;
+    uint64_t Hash;
+    uint32_t NumBlocks;
+    uint32_t NumNodes;
+    uint32_t NumEdges;
+    uint32_t Reserved;
+  };
+
+  size_t getFileSize(uint32_t NumNodes, uint32_t NumEdges)
+  {
+    return sizeof(CacheHeader) +
+           sizeof(uint32_t) * (3 * size_t(NumNodes) + 2 + 2 * size_t(NumEdges)) +
+           2 * size_t(NumEdges);
+  }
+
+  /// FNV-1a hash of everything written to the stream.
+  class HashingStream : public raw_ostream
+  {
+  public:
+    HashingStream() : mHash(14695981039346656037ULL), mPos(0) { }
+
+    ~HashingStream()
+    {
+      flush();
+    }
+
+    uint64_t getHash()
+    {
+      flush();
+      return mHash;
+    }
+
+  private:
+    virtual void write_impl(const char *Ptr, size_t Size)
+    {
+      for (size_t I = 0; I != Size; ++I)
+      {
+        mHash ^= static_cast<unsigned char>(Ptr[I]);
+        mHash *= 1099511628211ULL;
+      }
+      mPos += Size;
+    }
+
+    virtual uint64_t current_pos() const
+    {
+      return mPos;
+    }
+
+    uint64_t mHash;
+    uint64_t mPos;
+  };
+
+  void getCachePath(uint64_t Hash, StringRef Kind,
+                    SmallVectorImpl<char> &Path)
+  {
+    Path.clear();
+    Path.append(CacheDir.begin(), CacheDir.end());
+    sys::path::append(Path, utohexstr(Hash) + "." + Kind);
+  }
+
+  /// Whether [Begin, Begin + Count + 1) is a valid CSR offset array.
+  bool checkOffsets(const uint32_t *Begin, uint32_t Count, uint32_t NumEdges)
+  {
+    if (Begin[0] != 0 || Begin[Count] != NumEdges)
+      return false;
+    for (uint32_t I = 0; I != Count; ++I)
+      if (Begin[I] > Begin[I + 1])
+        return false;
+    return true;
+  }
+
+  /*!
+   * Whether every list in the CSR arrays is strictly increasing and in range,
+   * and every link has a valid mask of kinds: branch labels only come with
+   * the control kind.
+   */
+  bool checkLists(const uint32_t *Begin, const uint32_t *IDs,
+                  const uint8_t *Types, uint32_t NumNodes)
+  {
+    for (uint32_t N = 0; N != NumNodes; ++N)
+      for (uint32_t L = Begin[N]; L != Begin[N + 1]; ++L)
+        if (IDs[L] >= NumNodes || (L != Begin[N] && IDs[L] <= IDs[L - 1]) ||
+            !Types[L] || ((Types[L] & BranchKindMask) &&
+                          !(Types[L] & (1U << CONTROL_DEPENDENCE))))
+          return false;
+    return true;
+  }
+}
+
+
+bool cot::isGraphCacheEnabled()
+{
+  return !CacheDir.empty();
+}
+
+
+uint64_t cot::hashFunctionIR(const Function &F)
+{
+  HashingStream OS;
+  OS << "cot-dg-cache " << CacheVersion << '\0' << CacheSalt << '\0'
+     << usesAliasSetDependences() << '\0' << getMemoryLinkBudget() << '\0';
+  F.print(OS);
+  return OS.getHash();
+}
+
+
+static bool loadGraph(const Function &F, uint64_t Hash, StringRef Kind,
+                      DependencyGraph<BasicBlock> &G)
+{
+  SmallString<128> Path;
+  getCachePath(Hash, Kind, Path);
+  OwningPtr<MemoryBuffer> Buf;
+  if (MemoryBuffer::getFile(Path.str(), Buf, -1, false))
+    return false;
+
+  // Reject anything that is not a cache file written for F by this host.
+  const char *Start = Buf->getBufferStart();
+  size_t Size = Buf->getBufferSize();
+  if (Size < sizeof(CacheHeader) ||
+      reinterpret_cast<uintptr_t>(Start) % sizeof(uint64_t))
+    return false;
+  const CacheHeader *H = reinterpret_cast<const CacheHeader *>(Start);
+  if (std::memcmp(H->Magic, CacheMagic, sizeof(CacheMagic)) ||
+      H->Endian != CacheEndian || H->Version != CacheVersion ||
+      H->Hash != Hash || H->NumBlocks != F.size() || H->NumNodes == 0 ||
+      Size != getFileSize(H->NumNodes, H->NumEdges))
+    return false;
+
+  uint32_t NumNodes = H->NumNodes;
+  uint32_t NumEdges = H->NumEdges;
+  const uint32_t *NodeBlocks = reinterpret_cast<const uint32_t *>(H + 1);
+  const uint32_t *EdgeBegin = NodeBlocks + NumNodes;
+  const uint32_t *EdgeTargets = EdgeBegin + NumNodes + 1;
+  const uint32_t *PredBegin = EdgeTargets + NumEdges;
+  const uint32_t *PredSources = PredBegin + NumNodes + 1;
+  const uint8_t *EdgeTypes = reinterpret_cast<const uint8_t *>(PredSources +
+                                                               NumEdges);
+  const uint8_t *PredTypes = EdgeTypes + NumEdges;
+
+  if (!checkOffsets(EdgeBegin, NumNodes, NumEdges) ||
+      !checkOffsets(PredBegin, NumNodes, NumEdges) ||
+      !checkLists(EdgeBegin, EdgeTargets, EdgeTypes, NumNodes) ||
+      !checkLists(PredBegin, PredSources, PredTypes, NumNodes))
+    return false;
+
+  // Nodes refer to blocks by position; each block has at most one node.
+  std::vector<const BasicBlock *> Blocks;
+  Blocks.reserve(F.size());
+  for (Function::const_iterator I = F.begin(), E = F.end(); I != E; ++I)
+    Blocks.push_back(I);
+  std::vector<bool> Used(F.size() + 2, false);
+  std::vector<const BasicBlock *> Data(NumNodes);
+  for (uint32_t ID = 0; ID != NumNodes; ++ID)
+  {
+    uint32_t B = NodeBlocks[ID];
+    if (B != EntryBlock && B != MemoryStateBlock && B >= Blocks.size())
+      return false;
+    uint32_t Slot = B == EntryBlock ? Blocks.size()
+                  : B == MemoryStateBlock ? Blocks.size() + 1 : B;
+    if (Used[Slot])
+      return false;
+    Used[Slot] = true;
+    if (B == EntryBlock)
+      Data[ID] = 0;
+    else if (B == MemoryStateBlock)
+      Data[ID] = getMemoryStateData<BasicBlock>();
+    else
+      Data[ID] = Blocks[B];
+  }
+
+  G.clear();
+  G.freezeMapped(&Data[0], NumNodes, NumEdges, EdgeBegin, EdgeTargets,
+                 EdgeTypes, PredBegin, PredSources, PredTypes, Buf.take());
+  return true;
+}
+
+
+bool cot::hasCachedGraph(uint64_t Hash, StringRef Kind)
+{
+  SmallString<128> Path;
+  getCachePath(Hash, Kind, Path);
+  bool Exists;
+  if (sys::fs::exists(Path.str(), Exists) || !Exists)
+  {
+    ++NumCacheMisses;
+    return false;
+  }
+  return true;
+}
+
+
+bool cot::loadCachedGraph(const Function &F, uint64_t Hash, StringRef Kind,
+                          DependencyGraph<BasicBlock> &G)
+{
+  if (loadGraph(F, Hash, Kind, G))
+  {
+    ++NumCacheHits;
+    return true;
+  }
+  ++NumCacheMisses;
+  return false;
+}
+
+
+void cot::storeCachedGraph(const Function &F, uint64_t Hash, StringRef Kind,
+                           const DependencyGraph<BasicBlock> &G)
+{
+  uint32_t NumNodes = G.getNumNodes();
+  uint32_t NumEdges = G.getNumEdges();
+  if (!G.isFrozen() || !NumNodes)
+    return;
+
+  DenseMap<const BasicBlock *, uint32_t> BlockIndex;
+  uint32_t Index = 0;
+  for (Function::const_iterator I = F.begin(), E = F.end(); I != E; ++I)
+    BlockIndex[I] = Index++;
+
+  std::vector<uint32_t> NodeBlocks(NumNodes);
+  std::vector<uint32_t> EdgeBegin(NumNodes + 1);
+  std::vector<uint32_t> PredBegin(NumNodes + 1);
+  const uint32_t *Targets = G.targets_begin(0);
+  const uint32_t *Sources = G.sources_begin(0);
+  for (uint32_t ID = 0; ID != NumNodes; ++ID)
+  {
+    const BasicBlock *BB = G.getNode(ID)->getData();
+    if (!BB)
+      NodeBlocks[ID] = EntryBlock;
+    else if (BB == getMemoryStateData<BasicBlock>())
+      NodeBlocks[ID] = MemoryStateBlock;
+    else
+      NodeBlocks[ID] = BlockIndex.lookup(BB);
+    EdgeBegin[ID] = G.targets_begin(ID) - Targets;
+    PredBegin[ID] = G.sources_begin(ID) - Sources;
+  }
+  EdgeBegin[NumNodes] = NumEdges;
+  PredBegin[NumNodes] = NumEdges;
+
+  CacheHeader H;
+  std::memset(&H, 0, sizeof(H));
+  std::memcpy(H.Magic, CacheMagic, sizeof(CacheMagic));
+  H.Endian = CacheEndian;
+  H.Version = CacheVersion;
+  H.Hash = Hash;
+  H.NumBlocks = F.size();
+  H.NumNodes = NumNodes;
+  H.NumEdges = NumEdges;
+
+  // Write aside, then rename over the final name.
+  bool Existed;
+  if (sys::fs::create_directories(Twine(CacheDir), Existed))
+    return;
+  SmallString<128> Path;
+  getCachePath(Hash, Kind, Path);
+  SmallString<128> TempPath;
+  int FD;
+  if (sys::fs::unique_file(Twine(Path.str()) + "-%%%%%%%%", FD, TempPath))
+    return;
+
+  {
+    raw_fd_ostream OS(FD, true);
+    OS.write(reinterpret_cast<const char *>(&H), sizeof(H));
+    OS.write(reinterpret_cast<const char *>(&NodeBlocks[0]),
+             NumNodes * sizeof(uint32_t));
+    OS.write(reinterpret_cast<const char *>(&EdgeBegin[0]),
+             (NumNodes + 1) * sizeof(uint32_t));
+    OS.write(reinterpret_cast<const char *>(Targets),
+             NumEdges * sizeof(uint32_t));
+    OS.write(reinterpret_cast<const char *>(&PredBegin[0]),
+             (NumNodes + 1) * sizeof(uint32_t));
+    OS.write(reinterpret_cast<const char *>(Sources),
+             NumEdges * sizeof(uint32_t));
+    OS.write(reinterpret_cast<const char *>(G.types_begin(0)), NumEdges);
+    OS.write(reinterpret_cast<const char *>(G.source_types_begin(0)),
+             NumEdges);
+    OS.close();
+    if (OS.has_error())
+    {
+      OS.clear_error();
+      sys::fs::remove(TempPath.str(), Existed);
+      return;
+    }
+  }
+
+  if (sys::fs::rename(TempPath.str(), Path.str()))
+    sys::fs::remove(TempPath.str(), Existed);
+  else
+    ++NumCacheStores;
+}
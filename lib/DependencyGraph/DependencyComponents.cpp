@@ -0,0 +1,185 @@
+/** ---*- C++ -*--- DependencyComponents.cpp
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "cot/DependencyGraph/DependencyComponents.h"
+
+#include <algorithm>
+
+using namespace cot;
+
+
+namespace
+{
+  /// A node whose links are being visited, with the next link to follow.
+  struct Frame
+  {
+    uint32_t Node;
+    uint32_t Next;
+  };
+}
+
+
+void DependencyComponents::compute(uint32_t NumNodes, const uint32_t *Begin,
+                                   const uint32_t *Targets)
+{
+  computeComponents(NumNodes, Begin, Targets);
+  buildCondensation(NumNodes, Begin, Targets);
+  computeLevels();
+}
+
+
+/*!
+ * Tarjan's algorithm, with an explicit call stack. A component is numbered
+ * when its root is left, after all the components it reaches.
+ */
+void DependencyComponents::computeComponents(uint32_t NumNodes,
+                                             const uint32_t *Begin,
+                                             const uint32_t *Targets)
+{
+  const uint32_t Unvisited = ~0U;
+  std::vector<uint32_t> Index(NumNodes, Unvisited);
+  std::vector<uint32_t> Low(NumNodes);
+  std::vector<uint32_t> Stack;
+  std::vector<Frame> Calls;
+  mComponent.assign(NumNodes, Unvisited);
+  mNumComponents = 0;
+  uint32_t NextIndex = 0;
+
+  for (uint32_t Root = 0; Root != NumNodes; ++Root)
+  {
+    if (Index[Root] != Unvisited)
+      continue;
+
+    Frame RootFrame = { Root, Begin[Root] };
+    Calls.push_back(RootFrame);
+    Index[Root] = Low[Root] = NextIndex++;
+    Stack.push_back(Root);
+
+    while (!Calls.empty())
+    {
+      Frame &Top = Calls.back();
+      uint32_t V = Top.Node;
+      if (Top.Next != Begin[V + 1])
+      {
+        uint32_t W = Targets[Top.Next++];
+        if (Index[W] == Unvisited)
+        {
+          Frame F = { W, Begin[W] };
+          Calls.push_back(F);
+          Index[W] = Low[W] = NextIndex++;
+          Stack.push_back(W);
+        }
+        else if (mComponent[W] == Unvisited)
+          // W is still on the stack.
+          Low[V] = std::min(Low[V], Index[W]);
+        continue;
+      }
+
+      Calls.pop_back();
+      if (!Calls.empty())
+      {
+        uint32_t Parent = Calls.back().Node;
+        Low[Parent] = std::min(Low[Parent], Low[V]);
+      }
+      if (Low[V] != Index[V])
+        continue;
+
+      uint32_t W;
+      do
+      {
+        W = Stack.back();
+        Stack.pop_back();
+        mComponent[W] = mNumComponents;
+      } while (W != V);
+      ++mNumComponents;
+    }
+  }
+}
+
+
+void DependencyComponents::buildCondensation(uint32_t NumNodes,
+                                             const uint32_t *Begin,
+                                             const uint32_t *Targets)
+{
+  // Group nodes by component.
+  mMemberBegin.assign(mNumComponents + 1, 0);
+  for (uint32_t ID = 0; ID != NumNodes; ++ID)
+    ++mMemberBegin[mComponent[ID] + 1];
+  for (uint32_t C = 0; C != mNumComponents; ++C)
+    mMemberBegin[C + 1] += mMemberBegin[C];
+  mMembers.resize(NumNodes);
+  std::vector<uint32_t> Pos(mMemberBegin.begin(), mMemberBegin.end() - 1);
+  for (uint32_t ID = 0; ID != NumNodes; ++ID)
+    mMembers[Pos[mComponent[ID]]++] = ID;
+
+  // Links among components, each kept once.
+  const uint32_t None = ~0U;
+  std::vector<uint32_t> LastSource(mNumComponents, None);
+  mDagBegin.assign(mNumComponents + 1, 0);
+  mDagTargets.clear();
+  for (uint32_t C = 0; C != mNumComponents; ++C)
+  {
+    for (uint32_t M = mMemberBegin[C]; M != mMemberBegin[C + 1]; ++M)
+      for (uint32_t L = Begin[mMembers[M]]; L != Begin[mMembers[M] + 1]; ++L)
+      {
+        uint32_t D = mComponent[Targets[L]];
+        if (D == C || LastSource[D] == C)
+          continue;
+        LastSource[D] = C;
+        mDagTargets.push_back(D);
+      }
+    mDagBegin[C + 1] = mDagTargets.size();
+  }
+}
+
+
+void DependencyComponents::computeLevels()
+{
+  // Sources come last, so a downward walk sets the level of a component
+  // before following its links.
+  mLevel.assign(mNumComponents, 0);
+  mNumLevels = 0;
+  for (uint32_t C = mNumComponents; C-- != 0; )
+  {
+    mNumLevels = std::max(mNumLevels, mLevel[C] + 1);
+    for (uint32_t L = mDagBegin[C]; L != mDagBegin[C + 1]; ++L)
+    {
+      uint32_t D = mDagTargets[L];
+      mLevel[D] = std::max(mLevel[D], mLevel[C] + 1);
+    }
+  }
+
+  mLevelBegin.assign(mNumLevels + 1, 0);
+  for (uint32_t C = 0; C != mNumComponents; ++C)
+    ++mLevelBegin[mLevel[C] + 1];
+  for (uint32_t L = 0; L != mNumLevels; ++L)
+    mLevelBegin[L + 1] += mLevelBegin[L];
+  mByLevel.resize(mNumComponents);
+  std::vector<uint32_t> Pos(mLevelBegin.begin(), mLevelBegin.end() - 1);
+  for (uint32_t C = mNumComponents; C-- != 0; )
+    mByLevel[Pos[mLevel[C]]++] = C;
+}
+
+
+size_t DependencyComponents::getMemoryUsage() const
+{
+  return (mComponent.capacity() + mMemberBegin.capacity() +
+          mMembers.capacity() + mDagBegin.capacity() +
+          mDagTargets.capacity() + mLevel.capacity() +
+          mLevelBegin.capacity() + mByLevel.capacity()) * sizeof(uint32_t);
+}
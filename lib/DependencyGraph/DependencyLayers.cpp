@@ -0,0 +1,140 @@
+/** ---*- C++ -*--- DependencyLayers.cpp
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "cot/DependencyGraph/DependencyLayers.h"
+
+#include "cot/AllPasses.h"
+#include "cot/DependencyGraph/DependencyCache.h"
+#include "cot/Support/PhaseTimer.h"
+#include "llvm/Function.h"
+
+
+using namespace cot;
+using namespace llvm;
+
+
+/*!
+ * Cache kind of the graph holding the layers in TypeMask. Graphs are named
+ * after the analysis they stand for, so that the graph of both layers is
+ * the one the parallel driver caches too.
+ */
+static const char *getCacheKind(unsigned TypeMask)
+{
+  switch (TypeMask)
+  {
+  case ControlTypeMask:
+    return "cdg";
+  case DataTypeMask:
+    return "ddg";
+  default:
+    return "pdg";
+  }
+}
+
+
+char DependencyLayers::ID = 0;
+
+
+bool DependencyLayers::runOnFunction(Function &F)
+{
+  mGraph.clear();
+  mTypeMask = 0;
+  mHasHash = false;
+  return false;
+}
+
+
+void DependencyLayers::getAnalysisUsage(AnalysisUsage &AU) const
+{
+  AU.setPreservesAll();
+}
+
+
+uint64_t DependencyLayers::getHash(Function &F)
+{
+  if (!mHasHash)
+  {
+    mHash = hashFunctionIR(F);
+    mHasHash = true;
+  }
+  return mHash;
+}
+
+
+bool DependencyLayers::loadLayer(Function &F, DependencyType Type)
+{
+  if (!isGraphCacheEnabled())
+    return false;
+  unsigned TypeMask = mTypeMask | getDependencyTypeMask(Type);
+  if (!loadCachedGraph(F, getHash(F), getCacheKind(TypeMask), mGraph))
+    return false;
+  mTypeMask = TypeMask;
+  return true;
+}
+
+
+DepGraph &DependencyLayers::beginLayer(DependencyType Type)
+{
+  assert(!hasLayer(Type) && "Layer already built!");
+  if (mGraph.isFrozen())
+    mGraph.thaw();
+  return mGraph;
+}
+
+
+void DependencyLayers::endLayer(Function &F, DependencyType Type)
+{
+  {
+    PhaseTimer Phase("Graph freezing", F.getName());
+    mGraph.freeze(F.begin(), F.end());
+  }
+  mTypeMask |= getDependencyTypeMask(Type);
+  if (isGraphCacheEnabled())
+    storeCachedGraph(F, getHash(F), getCacheKind(mTypeMask), mGraph);
+}
+
+
+DepGraph &DependencyLayers::beginUpdate()
+{
+  if (mGraph.isFrozen())
+    mGraph.thaw();
+  return mGraph;
+}
+
+
+void DependencyLayers::endUpdate(Function &F)
+{
+  {
+    PhaseTimer Phase("Graph freezing", F.getName());
+    mGraph.freeze(F.begin(), F.end());
+  }
+  // The key of F changed with its IR.
+  mHasHash = false;
+}
+
+
+DependencyLayers *cot::CreateDependencyLayersPass()
+{
+  return new DependencyLayers();
+}
+
+
+INITIALIZE_PASS(DependencyLayers, "dg-layers",
+                "Dependency Graph Layers",
+                true,
+                true)
@@ -0,0 +1,315 @@
+/** ---*- C++ -*--- GraphExport.cpp
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "cot/DependencyGraph/GraphExport.h"
+
+#include "cot/AllPasses.h"
+#include "cot/DependencyGraph/ControlDependencies.h"
+#include "cot/DependencyGraph/DataDependencies.h"
+#include "cot/DependencyGraph/ProgramDependencies.h"
+#include "cot/DependencyGraph/Slicing.h"
+#include "llvm/Function.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+
+
+using namespace cot;
+using namespace llvm;
+
+
+static cl::opt<ExportFormat>
+Format("dg-export-format",
+       cl::desc("Format of exported dependency graphs"),
+       cl::values(clEnumValN(DOTExport, "dot", "Graphviz digraph"),
+                  clEnumValN(JSONExport, "json",
+                             "Newline-delimited JSON records"),
+                  clEnumValEnd),
+       cl::init(DOTExport));
+
+static cl::opt<bool>
+IDsOnly("dg-export-ids-only",
+        cl::desc("Export node IDs without labels"),
+        cl::init(false));
+
+static cl::bits<DependencyType>
+Types("dg-export-types",
+      cl::desc("Export only links of these types (default: all)"),
+      cl::values(clEnumValN(CONTROL, "control", "Control dependences"),
+                 clEnumValN(DATA, "data", "Data dependences"),
+                 clEnumValEnd),
+      cl::CommaSeparated);
+
+static cl::bits<DependencyKind>
+Kinds("dg-export-kinds",
+      cl::desc("Export only links of these kinds (default: all)"),
+      cl::values(clEnumValN(FLOW_DEPENDENCE, "flow", "Read after write"),
+                 clEnumValN(ANTI_DEPENDENCE, "anti", "Write after read"),
+                 clEnumValN(OUTPUT_DEPENDENCE, "output", "Write after write"),
+                 clEnumValN(MEMORY_DEPENDENCE, "memory",
+                            "Dependences through memory"),
+                 clEnumValN(CONTROL_DEPENDENCE, "control",
+                            "Control dependences"),
+                 clEnumValN(TRUE_BRANCH, "true", "Taken on a true condition"),
+                 clEnumValN(FALSE_BRANCH, "false",
+                            "Taken on a false condition"),
+                 clEnumValN(CASE_BRANCH, "case", "Taken on a switch case"),
+                 clEnumValEnd),
+      cl::CommaSeparated);
+
+static cl::list<std::string>
+SubgraphBlocks("dg-export-nodes",
+               cl::desc("Export only the subgraph induced by these blocks"),
+               cl::value_desc("name"),
+               cl::CommaSeparated);
+
+static cl::list<std::string>
+SliceCriteria("dg-export-slice",
+              cl::desc("Export only the slice from these blocks"),
+              cl::value_desc("name"),
+              cl::CommaSeparated);
+
+static cl::opt<SliceDirection>
+SliceDir("dg-export-slice-direction",
+         cl::desc("Direction of the exported slice"),
+         cl::values(clEnumValN(BackwardSlice, "backward",
+                               "What the blocks depend on"),
+                    clEnumValN(ForwardSlice, "forward",
+                               "What depends on the blocks"),
+                    clEnumValEnd),
+         cl::init(BackwardSlice));
+
+static cl::opt<std::string>
+OutputFile("dg-export-file",
+           cl::desc("File all exported graphs are written to, '-' for "
+                    "stdout (default: one file per function)"),
+           cl::value_desc("filename"),
+           cl::init(""));
+
+
+void cot::writeQuoted(raw_ostream &OS, StringRef S, ExportFormat Format)
+{
+  OS << '"';
+  for (StringRef::iterator I = S.begin(), E = S.end(); I != E; ++I)
+  {
+    unsigned char C = *I;
+    if (C == '"' || C == '\\')
+      OS << '\\' << C;
+    else if (C < 0x20 && Format == JSONExport)
+      OS << format("\\u%04x", C);
+    else if (C == '\n')
+      OS << "\\n";
+    else
+      OS << C;
+  }
+  OS << '"';
+}
+
+
+void cot::writeKinds(raw_ostream &OS, unsigned KindMask)
+{
+  OS << ",\"kinds\":[";
+  const char *Sep = "";
+  for (unsigned K = 0; K != NumDependencyKinds; ++K)
+    if (KindMask & (1U << K))
+    {
+      OS << Sep << '"' << getDependencyKindName(DependencyKind(K)) << '"';
+      Sep = ",";
+    }
+  OS << "]}\n";
+}
+
+
+/// Set in Nodes the IDs of the blocks of G named in Names.
+static void findBlocks(const DepGraph &G, const StringMap<const Value *> &Names,
+                       const cl::list<std::string> &Blocks, BitVector &Nodes)
+{
+  Nodes.reset();
+  Nodes.resize(G.getNumNodes());
+  for (cl::list<std::string>::const_iterator B = Blocks.begin(),
+         BE = Blocks.end(); B != BE; ++B)
+  {
+    StringRef Name(*B);
+    if (Name.startswith("%"))
+      Name = Name.substr(1);
+    StringMap<const Value *>::const_iterator V = Names.find(Name);
+    if (V == Names.end() || !isa<BasicBlock>(V->second))
+      continue;
+    if (const DepGraphNode *N = G.getNodeByData(cast<BasicBlock>(V->second)))
+      Nodes.set(N->getID());
+  }
+}
+
+
+bool DependencyGraphExporter::runOnFunction(Function &F)
+{
+  DepGraphView View = getGraph(F);
+  const DepGraph &G = View.getGraph();
+
+  ExportOptions Opts;
+  Opts.Format = Format;
+  Opts.IDsOnly = IDsOnly;
+  if (Types.getBits())
+  {
+    Opts.TypeMask = 0;
+    for (unsigned T = 0; T != NumDependencyTypes; ++T)
+      if (Types.isSet(T))
+        Opts.TypeMask |= getDependencyTypeMask(DependencyType(T));
+  }
+  if (Kinds.getBits())
+    Opts.TypeMask &= Kinds.getBits();
+
+  // Restrict the export to a slice, a subgraph, or both.
+  BitVector Nodes;
+  if (!SliceCriteria.empty() || !SubgraphBlocks.empty())
+  {
+    StringMap<const Value *> Names;
+    nameValues(F, Names);
+    BitVector Blocks;
+    if (!SliceCriteria.empty())
+    {
+      findBlocks(G, Names, SliceCriteria, Blocks);
+      std::vector<uint32_t> IDs;
+      for (int ID = Blocks.find_first(); ID != -1; ID = Blocks.find_next(ID))
+        IDs.push_back(ID);
+      DependencySlicer<BasicBlock> Slicer(G);
+      Nodes = Slicer.slice(IDs.begin(), IDs.end(), SliceDir,
+                           Opts.TypeMask & View.getTypeMask());
+    }
+    if (!SubgraphBlocks.empty())
+    {
+      findBlocks(G, Names, SubgraphBlocks, Blocks);
+      if (SliceCriteria.empty())
+        Nodes = Blocks;
+      else
+        Nodes &= Blocks;
+    }
+    Opts.Nodes = &Nodes;
+  }
+
+  if (!OutputFile.empty())
+  {
+    if (!mOutput)
+    {
+      std::string ErrorInfo;
+      mOutput.reset(new raw_fd_ostream(OutputFile.c_str(), ErrorInfo));
+      if (!ErrorInfo.empty())
+      {
+        errs() << "Error opening '" << OutputFile << "': " << ErrorInfo
+               << "\n";
+        mOutput.reset();
+        return false;
+      }
+    }
+    exportGraph(*mOutput, View, F.getName(), Opts);
+    return false;
+  }
+
+  std::string Filename = mName + "." + F.getName().str() +
+                         (Format == DOTExport ? ".dot" : ".ndjson");
+  errs() << "Writing '" << Filename << "'...";
+  std::string ErrorInfo;
+  raw_fd_ostream File(Filename.c_str(), ErrorInfo);
+  if (ErrorInfo.empty())
+    exportGraph(File, View, F.getName(), Opts);
+  else
+    errs() << "  error opening file for writing!";
+  errs() << "\n";
+  return false;
+}
+
+
+bool DependencyGraphExporter::doFinalization(Module &M)
+{
+  mOutput.reset();
+  return false;
+}
+
+
+namespace cot
+{
+namespace {
+struct DataDependencyExporter : public DependencyGraphExporter
+{
+  static char ID;
+  DataDependencyExporter() : DependencyGraphExporter(ID, "ddg") {}
+
+  void getAnalysisUsage(AnalysisUsage &AU) const
+  {
+    AU.setPreservesAll();
+    AU.addRequired<DataDependencyGraph>();
+  }
+
+  DepGraphView getGraph(Function &F)
+  {
+    return getAnalysis<DataDependencyGraph>().DDG;
+  }
+};
+
+
+struct ControlDependencyExporter : public DependencyGraphExporter
+{
+  static char ID;
+  ControlDependencyExporter() : DependencyGraphExporter(ID, "cdg") {}
+
+  void getAnalysisUsage(AnalysisUsage &AU) const
+  {
+    AU.setPreservesAll();
+    AU.addRequired<ControlDependencyGraph>();
+  }
+
+  DepGraphView getGraph(Function &F)
+  {
+    return getAnalysis<ControlDependencyGraph>().CDG;
+  }
+};
+
+
+struct ProgramDependencyExporter : public DependencyGraphExporter
+{
+  static char ID;
+  ProgramDependencyExporter() : DependencyGraphExporter(ID, "pdg") {}
+
+  void getAnalysisUsage(AnalysisUsage &AU) const
+  {
+    AU.setPreservesAll();
+    AU.addRequired<ProgramDependencyGraph>();
+  }
+
+  DepGraphView getGraph(Function &F)
+  {
+    return getAnalysis<ProgramDependencyGraph>().PDG;
+  }
+};
+}
+}
+
+
+char DataDependencyExporter::ID = 0;
+INITIALIZE_PASS(DataDependencyExporter, "export-ddg",
+                "Stream data dependency graph of function to a file",
+                false, false)
+
+char ControlDependencyExporter::ID = 0;
+INITIALIZE_PASS(ControlDependencyExporter, "export-cdg",
+                "Stream control dependency graph of function to a file",
+                false, false)
+
+char ProgramDependencyExporter::ID = 0;
+INITIALIZE_PASS(ProgramDependencyExporter, "export-pdg",
+                "Stream program dependency graph of function to a file",
+                false, false)
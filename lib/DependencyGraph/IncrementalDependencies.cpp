@@ -0,0 +1,356 @@
+/** ---*- C++ -*--- IncrementalDependencies.cpp
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#define DEBUG_TYPE "dg-update"
+#include "cot/DependencyGraph/IncrementalDependencies.h"
+
+#include "cot/DependencyGraph/ControlDependencies.h"
+#include "cot/DependencyGraph/DataDependencies.h"
+#include "cot/DependencyGraph/DependencyLayers.h"
+#include "cot/Support/PhaseTimer.h"
+#include "llvm/Function.h"
+#include "llvm/Instructions.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/Dominators.h"
+#include "llvm/ADT/BitVector.h"
+#include "llvm/ADT/DepthFirstIterator.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/CFG.h"
+
+
+using namespace cot;
+using namespace llvm;
+
+
+STATISTIC(NumUpdates, "Number of incremental dependency graph updates");
+STATISTIC(NumControlUpdates,
+          "Number of blocks whose control links were recomputed");
+STATISTIC(NumDataUpdates, "Number of blocks whose data links were recomputed");
+
+
+typedef SmallPtrSet<BasicBlock *, 16> BlockSet;
+
+
+/*!
+ * Add to Blocks the blocks of the nodes node ID of G has a memory link to,
+ * unless they are in Erased.
+ */
+static void addMemoryTargets(const DepGraph &G, uint32_t ID,
+                             const BitVector &Erased, BlockSet &Blocks)
+{
+  const uint8_t *Types = G.types_begin(ID);
+  for (const uint32_t *T = G.targets_begin(ID), *TE = G.targets_end(ID);
+       T != TE; ++T, ++Types)
+    if ((*Types & (1U << MEMORY_DEPENDENCE)) && !Erased.test(*T))
+      Blocks.insert(const_cast<BasicBlock *>(G.getNode(*T)->getData()));
+}
+
+
+/*!
+ * Add to Blocks the blocks reachable from those of Changed that hold a store
+ * which may alias a store of Changed: a store added to or moved into these
+ * blocks may be their new dependence.
+ */
+static void addAliasingStores(const BlockSet &Changed, AliasAnalysis &AA,
+                              BlockSet &Blocks)
+{
+  SmallVector<AliasAnalysis::Location, 8> Locs;
+  SmallVector<BasicBlock *, 32> Worklist;
+  BlockSet Visited;
+  for (BlockSet::const_iterator I = Changed.begin(), E = Changed.end();
+       I != E; ++I)
+  {
+    for (BasicBlock::iterator II = (*I)->begin(), IE = (*I)->end(); II != IE;
+         ++II)
+      if (StoreInst *SI = dyn_cast<StoreInst>(II))
+        Locs.push_back(AA.getLocation(SI));
+    for (succ_iterator S = succ_begin(*I), SE = succ_end(*I); S != SE; ++S)
+      if (Visited.insert(*S))
+        Worklist.push_back(*S);
+  }
+  if (Locs.empty())
+    return;
+
+  while (!Worklist.empty())
+  {
+    BasicBlock *BB = Worklist.pop_back_val();
+    for (succ_iterator S = succ_begin(BB), SE = succ_end(BB); S != SE; ++S)
+      if (Visited.insert(*S))
+        Worklist.push_back(*S);
+    if (Blocks.count(BB))
+      continue;
+
+    for (BasicBlock::iterator II = BB->begin(), IE = BB->end(); II != IE;
+         ++II)
+    {
+      StoreInst *SI = dyn_cast<StoreInst>(II);
+      if (!SI)
+        continue;
+      AliasAnalysis::Location Loc = AA.getLocation(SI);
+      bool MayAlias = false;
+      for (unsigned L = 0, LE = Locs.size(); L != LE && !MayAlias; ++L)
+        MayAlias = AA.alias(Loc, Locs[L]) != AliasAnalysis::NoAlias;
+      if (MayAlias)
+      {
+        Blocks.insert(BB);
+        break;
+      }
+    }
+  }
+}
+
+
+DependencyUpdater::BlockHandle::BlockHandle(BasicBlock *BB,
+                                            DependencyUpdater *Updater) :
+CallbackVH(BB), mUpdater(Updater) { }
+
+
+void DependencyUpdater::BlockHandle::deleted()
+{
+  mUpdater->blockErased(static_cast<BasicBlock *>(getValPtr()));
+  setValPtr(0);
+}
+
+
+DependencyUpdater::DependencyUpdater(Function &F, DependencyLayers &Layers) :
+mF(F), mLayers(Layers)
+{
+  for (Function::iterator I = F.begin(), E = F.end(); I != E; ++I)
+    mHandles.push_back(BlockHandle(I, this));
+}
+
+
+void DependencyUpdater::blockInserted(BasicBlock *BB)
+{
+  mHandles.push_back(BlockHandle(BB, this));
+  mSuccessorsChanged.insert(BB);
+  mPostDominatorChanged.insert(BB);
+  mInstructionsChanged.insert(BB);
+}
+
+
+void DependencyUpdater::successorsChanged(BasicBlock *BB)
+{
+  mSuccessorsChanged.insert(BB);
+}
+
+
+void DependencyUpdater::postDominatorChanged(BasicBlock *BB)
+{
+  mPostDominatorChanged.insert(BB);
+}
+
+
+void DependencyUpdater::instructionsChanged(BasicBlock *BB)
+{
+  mInstructionsChanged.insert(BB);
+}
+
+
+void DependencyUpdater::instructionMoved(Instruction *I, BasicBlock *From)
+{
+  mInstructionsChanged.insert(From);
+  mInstructionsChanged.insert(I->getParent());
+}
+
+
+bool DependencyUpdater::hasPendingUpdates() const
+{
+  return !mSuccessorsChanged.empty() || !mPostDominatorChanged.empty() ||
+         !mInstructionsChanged.empty() || !mErased.empty();
+}
+
+
+void DependencyUpdater::blockErased(BasicBlock *BB)
+{
+  mSuccessorsChanged.erase(BB);
+  mPostDominatorChanged.erase(BB);
+  mInstructionsChanged.erase(BB);
+  mErased.push_back(BB);
+}
+
+
+void DependencyUpdater::update(DominatorTreeBase<BasicBlock> *PDT,
+                               AliasAnalysis *AA,
+                               MemoryDependenceAnalysis *MDA)
+{
+  bool Control = mLayers.hasLayer(CONTROL);
+  bool Data = mLayers.hasLayer(DATA);
+  if ((Control || Data) && hasPendingUpdates())
+  {
+    PhaseTimer Phase("Incremental update", mF.getName());
+    ++NumUpdates;
+
+    // What the edits touched is looked up in the graph before thawing it.
+    const DepGraph &Old = mLayers.getGraph();
+    BitVector Erased(Old.getNumNodes());
+    for (std::vector<const BasicBlock *>::iterator I = mErased.begin(),
+           E = mErased.end(); I != E; ++I)
+      if (const DepGraphNode *N = Old.getNodeByData(*I))
+        Erased.set(N->getID());
+
+    /*
+     * The control links from a block are those on the post-dominator tree
+     * paths from its successors. A path changes if it goes through a block
+     * whose immediate post-dominator changed, that is if it starts in its
+     * subtree; the block itself may lie there too.
+     */
+    BlockSet Controllers;
+    bool StartChanged = false;
+    if (Control)
+    {
+      assert(PDT && "The control layer needs the post-dominator tree!");
+      Controllers = mSuccessorsChanged;
+      SmallPtrSet<DomTreeNode *, 32> Visited;
+      for (BlockSet::iterator I = mPostDominatorChanged.begin(),
+             E = mPostDominatorChanged.end(); I != E; ++I)
+      {
+        DomTreeNode *Root = PDT->getNode(*I);
+        if (!Root)
+          continue;
+        typedef df_ext_iterator<DomTreeNode *,
+                                SmallPtrSet<DomTreeNode *, 32> > SubtreeItr;
+        for (SubtreeItr N = df_ext_begin(Root, Visited),
+               NE = df_ext_end(Root, Visited); N != NE; ++N)
+        {
+          BasicBlock *BB = N->getBlock();
+          if (!BB)
+            continue;
+          if (BB == &mF.getEntryBlock())
+            StartChanged = true;
+          Controllers.insert(BB);
+          for (pred_iterator P = pred_begin(BB), PE = pred_end(BB); P != PE;
+               ++P)
+            Controllers.insert(*P);
+        }
+      }
+      NumControlUpdates += Controllers.size();
+    }
+
+    /*
+     * Data links into a block come from the operands and the stores of its
+     * instructions, so they are recomputed for the changed blocks, for the
+     * blocks whose stores had a memory dependence in one of them, and for
+     * those whose stores may now depend on a store of one of them.
+     */
+    bool RebuildData = Data && (usesAliasSetDependences() ||
+                                getMemoryLinkBudget());
+    BlockSet Requery;
+    std::vector<std::pair<const BasicBlock *, BasicBlock *> > Incoming;
+    if (Data && !RebuildData)
+    {
+      assert(AA && MDA && "The data layer needs AA and MDA!");
+      Requery = mInstructionsChanged;
+      for (BlockSet::iterator I = mInstructionsChanged.begin(),
+             E = mInstructionsChanged.end(); I != E; ++I)
+        if (const DepGraphNode *N = Old.getNodeByData(*I))
+          addMemoryTargets(Old, N->getID(), Erased, Requery);
+      for (int ID = Erased.find_first(); ID != -1; ID = Erased.find_next(ID))
+        addMemoryTargets(Old, ID, Erased, Requery);
+      addAliasingStores(mInstructionsChanged, *AA, Requery);
+
+      for (BlockSet::iterator I = Requery.begin(), E = Requery.end(); I != E;
+           ++I)
+      {
+        const DepGraphNode *N = Old.getNodeByData(*I);
+        if (!N)
+          continue;
+        for (DepGraphNode::source_iterator S = N->source_begin(),
+               SE = N->source_end(); S != SE; ++S)
+          if ((S.getTypeMask() & DataTypeMask) && !Erased.test(S->getID()))
+            Incoming.push_back(std::make_pair(S->getData(), *I));
+      }
+      NumDataUpdates += Requery.size();
+    }
+
+    DepGraph &G = mLayers.beginUpdate();
+    for (std::vector<const BasicBlock *>::iterator I = mErased.begin(),
+           E = mErased.end(); I != E; ++I)
+      G.removeNode(*I);
+
+    if (Control)
+    {
+      if (StartChanged)
+      {
+        G.removeDependencies(static_cast<BasicBlock *>(0), ControlTypeMask);
+        addBlockControlDependencies(mF, 0, *PDT, G);
+      }
+      for (BlockSet::iterator I = Controllers.begin(), E = Controllers.end();
+           I != E; ++I)
+      {
+        G.removeDependencies(*I, ControlTypeMask);
+        addBlockControlDependencies(mF, *I, *PDT, G);
+      }
+    }
+
+    if (RebuildData)
+    {
+      assert(AA && MDA && "The data layer needs AA and MDA!");
+      for (Function::iterator I = mF.begin(), E = mF.end(); I != E; ++I)
+        G.removeDependencies(I, DataTypeMask);
+      G.removeNode(getMemoryStateData<BasicBlock>());
+      MemoryDependences Deps(getMemoryLinkBudget());
+      collectMemoryDependences(mF, *AA, *MDA, Deps);
+      addDataDependencies(mF, Deps, G);
+      NumDataUpdates += mF.size();
+    }
+    else if (Data)
+    {
+      for (unsigned i = 0, e = Incoming.size(); i != e; ++i)
+        G.removeDependencyTypes(Incoming[i].first, Incoming[i].second,
+                                DataTypeMask);
+      for (BlockSet::iterator I = mInstructionsChanged.begin(),
+             E = mInstructionsChanged.end(); I != E; ++I)
+        G.removeDependencies(*I, DataTypeMask);
+
+      // Links go from the block of the dependency to the dependent one.
+      MemoryDependences Deps;
+      for (BlockSet::iterator I = Requery.begin(), E = Requery.end(); I != E;
+           ++I)
+      {
+        for (BasicBlock::iterator II = (*I)->begin(), IE = (*I)->end();
+             II != IE; ++II)
+          for (Instruction::op_iterator OI = II->op_begin(),
+                 OE = II->op_end(); OI != OE; ++OI)
+            if (Instruction *Def = dyn_cast<Instruction>(*OI))
+              G.addDependency(Def->getParent(), *I, DATA);
+        collectBlockStoreDependences(**I, *AA, *MDA, Deps);
+      }
+      for (BlockSet::iterator I = mInstructionsChanged.begin(),
+             E = mInstructionsChanged.end(); I != E; ++I)
+        for (BasicBlock::iterator II = (*I)->begin(), IE = (*I)->end();
+             II != IE; ++II)
+          for (Value::use_iterator U = II->use_begin(), UE = II->use_end();
+               U != UE; ++U)
+            if (Instruction *User = dyn_cast<Instruction>(*U))
+              G.addDependency(*I, User->getParent(), DATA);
+      for (std::vector<MemoryDependences::Link>::const_iterator
+             I = Deps.Links.begin(), E = Deps.Links.end(); I != E; ++I)
+        G.addDependencyTypes(I->second->getParent(), I->first->getParent(),
+                             getMemoryDependenceKinds(I->first, I->second));
+    }
+
+    mLayers.endUpdate(mF);
+  }
+
+  mSuccessorsChanged.clear();
+  mPostDominatorChanged.clear();
+  mInstructionsChanged.clear();
+  mErased.clear();
+}
@@ -0,0 +1,146 @@
+/** ---*- C++ -*--- InstructionDependencies.cpp
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "cot/DependencyGraph/InstructionDependencies.h"
+
+#include "cot/AllPasses.h"
+#include "cot/DependencyGraph/ControlDependencies.h"
+#include "cot/DependencyGraph/DataDependencies.h"
+#include "llvm/Function.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/MemoryDependenceAnalysis.h"
+#include "llvm/Support/InstIterator.h"
+#include "llvm/Support/raw_ostream.h"
+
+
+using namespace cot;
+using namespace llvm;
+
+
+void cot::buildInstructionDependencies(Function &F,
+                                       const MemoryDependences &Deps,
+                                       const DepGraphView &CDG,
+                                       InstDepGraph &IDG)
+{
+  IDG.clear();
+
+  unsigned NumInsts = 0;
+  for (Function::iterator BB = F.begin(), E = F.end(); BB != E; ++BB)
+    NumInsts += BB->size();
+  IDG.reserve(NumInsts + 1);
+
+  // Def-use chains: every instruction depends on the instructions defining
+  // its operands. Links go from the dependency to the dependent, memory ones
+  // included.
+  for (inst_iterator I = inst_begin(F), E = inst_end(F); I != E; ++I)
+    for (Instruction::const_op_iterator OI = I->op_begin(), OE = I->op_end();
+         OI != OE; ++OI)
+      if (const Instruction *Def = dyn_cast<Instruction>(*OI))
+        IDG.addDependency(Def, &*I, DATA);
+
+  for (std::vector<MemoryDependences::Link>::const_iterator
+       I = Deps.Links.begin(), E = Deps.Links.end(); I != E; ++I)
+    IDG.addDependencyTypes(I->second, I->first,
+                           getMemoryDependenceKinds(I->first, I->second));
+
+  // A block controlling another one does so through its terminator, with
+  // the same kinds. Blocks depending on the entry node have their
+  // instructions linked to the entry node as well. These links are unique,
+  // so they skip the duplicate check.
+  typedef DepGraphView::nodes_iterator NodeItr;
+  for (NodeItr NI = CDG.begin_children(), NE = CDG.end_children();
+       NI != NE; ++NI)
+  {
+    const BasicBlock *From = (*NI)->getData();
+    const Instruction *Branch = From ? From->getTerminator() : 0;
+    for (DepGraphView::iterator I = CDG.begin(*NI), E = CDG.end(*NI);
+         I != E; ++I)
+    {
+      const BasicBlock *To = (*I)->getData();
+      IDG.addDependencies(Branch, To->begin(), To->end(), I.getTypeMask());
+    }
+  }
+
+  IDG.freeze(inst_begin(F), inst_end(F));
+}
+
+
+void cot::deriveBlockDependencies(Function &F, const InstDepGraph &IDG,
+                                  DependencyGraph<BasicBlock> &G,
+                                  unsigned TypeMask)
+{
+  G.clear();
+  G.reserve(F.size() + 1);
+
+  typedef InstDepGraph::const_nodes_iterator NodeItr;
+  for (NodeItr NI = IDG.begin_children(), NE = IDG.end_children();
+       NI != NE; ++NI)
+  {
+    const Instruction *From = (*NI)->getData();
+    const BasicBlock *FromBB = From ? From->getParent() : 0;
+    for (DependencyNode<Instruction>::const_iterator I = (*NI)->begin(),
+           E = (*NI)->end(); I != E; ++I)
+      if (unsigned Types = I.getTypeMask() & TypeMask)
+        G.addDependencyTypes(FromBB, (*I)->getData()->getParent(), Types);
+  }
+
+  G.freeze(F.begin(), F.end());
+}
+
+
+char InstructionDependencyGraph::ID = 0;
+
+
+bool InstructionDependencyGraph::runOnFunction(Function &F)
+{
+  AliasAnalysis &AA = getAnalysis<AliasAnalysis>();
+  MemoryDependenceAnalysis &MDA = getAnalysis<MemoryDependenceAnalysis>();
+  const DepGraphView &CDG = getAnalysis<ControlDependencyGraph>().CDG;
+
+  MemoryDependences Deps;
+  collectMemoryDependences(F, AA, MDA, Deps);
+  buildInstructionDependencies(F, Deps, CDG, *IDG);
+  return false;
+}
+
+
+void InstructionDependencyGraph::getAnalysisUsage(AnalysisUsage &AU) const
+{
+  AU.addRequiredTransitive<AliasAnalysis>();
+  AU.addRequiredTransitive<MemoryDependenceAnalysis>();
+  AU.addRequired<ControlDependencyGraph>();
+  AU.setPreservesAll();
+}
+
+
+void InstructionDependencyGraph::print(raw_ostream &OS, const Module*) const
+{
+  IDG->print(OS, getPassName());
+}
+
+
+InstructionDependencyGraph *cot::CreateInstructionDependencyGraphPass()
+{
+  return new InstructionDependencyGraph();
+}
+
+
+INITIALIZE_PASS(InstructionDependencyGraph, "idg",
+                "Instruction Dependency Graph Construction",
+                true,
+                true)
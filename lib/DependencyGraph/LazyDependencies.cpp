@@ -0,0 +1,364 @@
+/** ---*- C++ -*--- LazyDependencies.cpp
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#define DEBUG_TYPE "lazy-pdg"
+#include "cot/DependencyGraph/LazyDependencies.h"
+
+#include "cot/AllPasses.h"
+#include "cot/DependencyGraph/ControlDependencies.h"
+#include "cot/Support/PhaseTimer.h"
+#include "llvm/Function.h"
+#include "llvm/Instructions.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/MemoryDependenceAnalysis.h"
+#include "llvm/Analysis/PostDominators.h"
+#include "llvm/ADT/DepthFirstIterator.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/Support/CFG.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+
+
+using namespace cot;
+using namespace llvm;
+
+
+STATISTIC(NumLazyNodes,
+          "Number of blocks whose dependences were computed on demand");
+
+
+void LazyDependencyGraph::reset(Function &F, DominatorTreeBase<BasicBlock> &PDT,
+                                AliasAnalysis &AA,
+                                MemoryDependenceAnalysis &MDA,
+                                unsigned TypeMask)
+{
+  clear();
+  mF = &F;
+  mPDT = &PDT;
+  mAA = &AA;
+  mMDA = &MDA;
+  mTypeMask = TypeMask;
+
+  mBlocks.reserve(F.size() + 1);
+  mBlocks.push_back(0);
+  for (Function::iterator I = F.begin(), E = F.end(); I != E; ++I)
+  {
+    mIDs[I] = mBlocks.size();
+    mBlocks.push_back(I);
+  }
+  mDependences.resize(mBlocks.size());
+  mComputed.resize(mBlocks.size());
+}
+
+
+void LazyDependencyGraph::clear()
+{
+  mF = 0;
+  mPDT = 0;
+  mAA = 0;
+  mMDA = 0;
+  mTypeMask = 0;
+  mBlocks.clear();
+  mIDs.clear();
+  mDependences.clear();
+  mComputed.clear();
+  mSlice.clear();
+  mAliasSetDeps.clear();
+  mHasAliasSets = false;
+}
+
+
+const LazyDependencyGraph::DependenceList &
+LazyDependencyGraph::getDependences(uint32_t ID)
+{
+  assert(ID < getNumNodes() && "Node ID out of range!");
+  if (!mComputed.test(ID))
+    computeDependences(ID);
+  return mDependences[ID];
+}
+
+
+unsigned LazyDependencyGraph::getLinkTypes(uint32_t From, uint32_t To)
+{
+  const DependenceList &Deps = getDependences(To);
+  DependenceList::const_iterator I =
+    std::lower_bound(Deps.begin(), Deps.end(), Dependence(From, 0));
+  return I != Deps.end() && I->first == From ? I->second : 0;
+}
+
+
+void LazyDependencyGraph::computeDependences(uint32_t ID)
+{
+  mComputed.set(ID);
+  // The entry node depends on nothing.
+  const BasicBlock *BB = mBlocks[ID];
+  if (!BB)
+    return;
+  ++NumLazyNodes;
+
+  DependenceList &Deps = mDependences[ID];
+  if (mTypeMask & ControlTypeMask)
+    addControlDependences(BB, Deps);
+  if (mTypeMask & DataTypeMask)
+    addDataDependences(BB, Deps);
+
+  // As freezing does, merge the links from a node and drop self-loops.
+  std::sort(Deps.begin(), Deps.end());
+  DependenceList::iterator Out = Deps.begin();
+  for (DependenceList::iterator I = Deps.begin(), E = Deps.end(); I != E; ++I)
+  {
+    unsigned Types = I->second & mTypeMask;
+    if (I->first == ID || !Types)
+      continue;
+    if (Out != Deps.begin() && (Out - 1)->first == I->first)
+      (Out - 1)->second |= Types;
+    else
+      *Out++ = Dependence(I->first, Types);
+  }
+  Deps.erase(Out, Deps.end());
+}
+
+
+void LazyDependencyGraph::addControlDependences(const BasicBlock *BB,
+                                                DependenceList &Deps)
+{
+  BasicBlock *Block = const_cast<BasicBlock *>(BB);
+  DomTreeNode *Node = mPDT->getNode(Block);
+  if (!Node)
+    return;
+
+  // The post-dominators of the entry block depend on the entry node.
+  if (mPDT->dominates(Block, &mF->getEntryBlock()))
+    Deps.push_back(Dependence(0, 1U << CONTROL_DEPENDENCE));
+
+  /*
+   * An edge from X to S makes BB depend on X if BB post-dominates S but not
+   * X: BB is then on the post-dominator tree path that
+   * addControlDependencies() walks from S. These edges are those into the
+   * subtree of BB.
+   */
+  for (df_iterator<DomTreeNode *> N = df_begin(Node), NE = df_end(Node);
+       N != NE; ++N)
+  {
+    BasicBlock *S = N->getBlock();
+    for (pred_iterator P = pred_begin(S), PE = pred_end(S); P != PE; ++P)
+    {
+      BasicBlock *X = *P;
+      if (X == Block || mPDT->dominates(Block, X))
+        continue;
+      TerminatorInst *TI = X->getTerminator();
+      for (unsigned i = 0, e = TI->getNumSuccessors(); i != e; ++i)
+        if (TI->getSuccessor(i) == S)
+          Deps.push_back(Dependence(mIDs.lookup(X), getEdgeKinds(TI, i)));
+    }
+  }
+}
+
+
+void LazyDependencyGraph::addDataDependences(const BasicBlock *BB,
+                                             DependenceList &Deps)
+{
+  for (BasicBlock::const_iterator I = BB->begin(), E = BB->end(); I != E; ++I)
+    for (User::const_op_iterator OI = I->op_begin(), OE = I->op_end();
+         OI != OE; ++OI)
+      if (const Instruction *Def = dyn_cast<Instruction>(*OI))
+        Deps.push_back(Dependence(mIDs.lookup(Def->getParent()),
+                                  1U << FLOW_DEPENDENCE));
+
+  // Alias set pairs need the accesses of the whole function.
+  MemoryDependences BlockDeps;
+  const MemoryDependences *Memory = &BlockDeps;
+  if (usesAliasSetDependences())
+  {
+    if (!mHasAliasSets)
+    {
+      MemoryDependences All;
+      collectAliasSetDependences(*mF, *mAA, All);
+      mAliasSetDeps.resize(getNumNodes());
+      for (std::vector<MemoryDependences::Link>::const_iterator
+             L = All.Links.begin(), LE = All.Links.end(); L != LE; ++L)
+        mAliasSetDeps[mIDs.lookup(L->first->getParent())].Links.push_back(*L);
+      mHasAliasSets = true;
+    }
+    Memory = &mAliasSetDeps[mIDs.lookup(BB)];
+  }
+  else
+    collectBlockStoreDependences(*const_cast<BasicBlock *>(BB), *mAA, *mMDA,
+                                 BlockDeps);
+
+  for (std::vector<MemoryDependences::Link>::const_iterator
+         L = Memory->Links.begin(), LE = Memory->Links.end(); L != LE; ++L)
+    Deps.push_back(Dependence(mIDs.lookup(L->second->getParent()),
+                              getMemoryDependenceKinds(L->first, L->second)));
+}
+
+
+void LazyDependencyGraph::sliceBackward(std::vector<uint32_t> &Worklist)
+{
+  while (!Worklist.empty())
+  {
+    uint32_t ID = Worklist.back();
+    Worklist.pop_back();
+    const DependenceList &Deps = getDependences(ID);
+    for (DependenceList::const_iterator I = Deps.begin(), E = Deps.end();
+         I != E; ++I)
+      if (!mSlice.test(I->first))
+      {
+        mSlice.set(I->first);
+        Worklist.push_back(I->first);
+      }
+  }
+}
+
+
+void LazyDependencyGraph::sliceForward(std::vector<uint32_t> &Worklist)
+{
+  std::vector<DependenceList> Links;
+  getLinks(Links);
+  while (!Worklist.empty())
+  {
+    uint32_t ID = Worklist.back();
+    Worklist.pop_back();
+    for (DependenceList::const_iterator I = Links[ID].begin(),
+           E = Links[ID].end(); I != E; ++I)
+      if (!mSlice.test(I->first))
+      {
+        mSlice.set(I->first);
+        Worklist.push_back(I->first);
+      }
+  }
+}
+
+
+void LazyDependencyGraph::getLinks(std::vector<DependenceList> &Links)
+{
+  Links.assign(getNumNodes(), DependenceList());
+  for (uint32_t To = 0, E = getNumNodes(); To != E; ++To)
+  {
+    const DependenceList &Deps = getDependences(To);
+    for (DependenceList::const_iterator I = Deps.begin(), IE = Deps.end();
+         I != IE; ++I)
+      Links[I->first].push_back(Dependence(To, I->second));
+  }
+}
+
+
+void LazyDependencyGraph::getControlDependencies(DependencyGraph<BasicBlock> &G)
+{
+  G.clear();
+  G.reserve(getNumNodes());
+  DependenceList Control;
+  for (uint32_t ID = 1, E = getNumNodes(); ID != E; ++ID)
+  {
+    const DependenceList *Deps = &mDependences[ID];
+    if (!mComputed.test(ID))
+    {
+      Control.clear();
+      if (mTypeMask & ControlTypeMask)
+        addControlDependences(mBlocks[ID], Control);
+      Deps = &Control;
+    }
+    for (DependenceList::const_iterator I = Deps->begin(), IE = Deps->end();
+         I != IE; ++I)
+      if (unsigned Types = I->second & mTypeMask & ControlTypeMask)
+        G.addDependencyTypes(mBlocks[I->first], mBlocks[ID], Types);
+  }
+  G.freeze(mF->begin(), mF->end());
+}
+
+
+/// Print the label of node ID, as the nodes of frozen graphs are printed.
+static void writeLabel(raw_ostream &OS, const LazyDependencyGraph &G,
+                       uint32_t ID)
+{
+  if (const BasicBlock *BB = G.getBlock(ID))
+    WriteAsOperand(OS, BB, false);
+  else
+    OS << "<<EntryNode>>";
+}
+
+
+void LazyDependencyGraph::print(raw_ostream &OS, const char *PN)
+{
+  std::vector<DependenceList> Links;
+  getLinks(Links);
+
+  OS << "=============================--------------------------------\n";
+  OS << PN << ": \n";
+  // As in views, the entry node only belongs to graphs of control links.
+  for (uint32_t ID = mTypeMask & ControlTypeMask ? 0 : 1, E = getNumNodes();
+       ID != E; ++ID)
+  {
+    OS.indent(4);
+    writeLabel(OS, *this, ID);
+    OS << " { ";
+    for (DependenceList::const_iterator I = Links[ID].begin(),
+           IE = Links[ID].end(); I != IE; ++I)
+      for (unsigned T = NumDependencyTypes; T-- != 0; )
+        if (I->second & getDependencyTypeMask(static_cast<DependencyType>(T)))
+        {
+          writeLabel(OS, *this, I->first);
+          OS << ":" << T << " ";
+        }
+    OS << "}\n";
+  }
+}
+
+
+char LazyProgramDependencyGraph::ID = 0;
+
+
+bool LazyProgramDependencyGraph::runOnFunction(Function &F)
+{
+  TraceEvent Trace(getPassName(), F.getName());
+  LPDG.reset(F, *getAnalysis<PostDominatorTree>().DT,
+             getAnalysis<AliasAnalysis>(),
+             getAnalysis<MemoryDependenceAnalysis>());
+  return false;
+}
+
+
+void LazyProgramDependencyGraph::getAnalysisUsage(AnalysisUsage &AU) const
+{
+  // Queries come after the pass ran.
+  AU.addRequiredTransitive<PostDominatorTree>();
+  AU.addRequiredTransitive<AliasAnalysis>();
+  AU.addRequiredTransitive<MemoryDependenceAnalysis>();
+  AU.setPreservesAll();
+}
+
+
+void LazyProgramDependencyGraph::print(raw_ostream &OS, const Module*) const
+{
+  PhaseTimer Phase("Printing", StringRef());
+  // Printing computes the nodes no query reached yet.
+  const_cast<LazyDependencyGraph &>(LPDG).print(OS, getPassName());
+}
+
+
+LazyProgramDependencyGraph *cot::CreateLazyProgramDependencyGraphPass()
+{
+  return new LazyProgramDependencyGraph();
+}
+
+
+INITIALIZE_PASS(LazyProgramDependencyGraph, "lazy-pdg",
+                "Lazy Program Dependency Graph Construction",
+                true,
+                true)
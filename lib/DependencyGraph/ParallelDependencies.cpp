@@ -0,0 +1,227 @@
+/** ---*- C++ -*--- ParallelDependencies.cpp
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "cot/DependencyGraph/ParallelDependencies.h"
+
+#include "cot/AllPasses.h"
+#include "cot/DependencyGraph/ControlDependencies.h"
+#include "cot/DependencyGraph/DataDependencies.h"
+#include "cot/DependencyGraph/DependencyCache.h"
+#include "cot/DependencyGraph/ProgramDependencies.h"
+#include "cot/Support/PhaseTimer.h"
+#include "cot/Support/WorkStealingPool.h"
+#include "llvm/Function.h"
+#include "llvm/Module.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/Dominators.h"
+#include "llvm/Analysis/MemoryDependenceAnalysis.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Threading.h"
+#include "llvm/Support/raw_ostream.h"
+
+
+using namespace cot;
+using namespace llvm;
+
+
+static cl::opt<unsigned>
+NumThreads("dg-threads",
+           cl::desc("Number of threads building dependency graphs "
+                    "(0: one per core)"),
+           cl::init(0));
+
+
+namespace {
+
+/// Per-worker storage, reused for every function the worker builds.
+struct WorkerGraphs
+{
+  WorkerGraphs() : PDT(true) { }
+
+  DominatorTreeBase<BasicBlock> PDT;
+  ProgramDepGraph PDG;
+};
+
+struct DriverState
+{
+  std::vector<Function *> Functions;
+  std::vector<MemoryDependences> MemDeps;
+  std::vector<uint64_t> Hashes;
+  /// Whether the driver found a cache file for each function.
+  std::vector<char> Cached;
+  /// Whether a worker failed to load that file.
+  std::vector<char> Failed;
+  /// Index in Functions of each task of the current round.
+  std::vector<unsigned> Tasks;
+  std::vector<WorkerGraphs *> Workers;
+  std::vector<std::string> *Output;
+};
+
+void buildFunctionGraphs(void *Context, unsigned Task, unsigned Worker)
+{
+  DriverState &S = *static_cast<DriverState *>(Context);
+  unsigned Index = S.Tasks[Task];
+  Function &F = *S.Functions[Index];
+  WorkerGraphs &W = *S.Workers[Worker];
+  TraceEvent Trace("Dependency graphs", F.getName(), Worker);
+  bool UseCache = isGraphCacheEnabled();
+
+  if (UseCache && S.Cached[Index] && !S.Failed[Index])
+  {
+    // A file that cannot be used leaves the function to the next round,
+    // once the driver has its memory dependences.
+    if (!loadCachedGraph(F, S.Hashes[Index], "pdg", W.PDG))
+    {
+      S.Failed[Index] = true;
+      return;
+    }
+  }
+  else
+  {
+    W.PDT.recalculate(F);
+    buildProgramDependencies(F, W.PDT, S.MemDeps[Index], W.PDG);
+    if (UseCache)
+      storeCachedGraph(F, S.Hashes[Index], "pdg", W.PDG);
+  }
+
+  raw_string_ostream OS((*S.Output)[Index]);
+  OS << "Function '" << F.getName() << "':\n";
+  DepGraphView(W.PDG, ControlTypeMask).print(OS, "Control Dependency Graph");
+  DepGraphView(W.PDG, DataTypeMask).print(OS, "Data Dependency Graph");
+  DepGraphView(W.PDG, ControlTypeMask | DataTypeMask)
+    .print(OS, "Program Dependency Graph");
+}
+
+} // End anonymous namespace.
+
+
+char ParallelDependencyGraphs::ID = 0;
+
+
+bool ParallelDependencyGraphs::runOnModule(Module &M)
+{
+  DriverState S;
+  for (Module::iterator I = M.begin(), E = M.end(); I != E; ++I)
+    if (!I->isDeclaration())
+      S.Functions.push_back(I);
+
+  /*
+   * Memory dependence queries cannot run concurrently, so they are issued
+   * here. Functions with a cached graph need none: the driver only checks
+   * that the file exists, and the workers load it.
+   */
+  AliasAnalysis &AA = getAnalysis<AliasAnalysis>();
+  bool UseCache = isGraphCacheEnabled();
+  S.MemDeps.resize(S.Functions.size(),
+                   MemoryDependences(getMemoryLinkBudget()));
+  if (UseCache)
+  {
+    S.Hashes.resize(S.Functions.size());
+    S.Cached.assign(S.Functions.size(), false);
+    S.Failed.assign(S.Functions.size(), false);
+  }
+  for (unsigned I = 0, E = S.Functions.size(); I != E; ++I)
+  {
+    Function &F = *S.Functions[I];
+    S.Tasks.push_back(I);
+    if (UseCache)
+    {
+      S.Hashes[I] = hashFunctionIR(F);
+      if (hasCachedGraph(S.Hashes[I], "pdg"))
+      {
+        S.Cached[I] = true;
+        continue;
+      }
+    }
+    TraceEvent Trace("Memory dependences", F.getName());
+    collectMemoryDependences(F, AA, getAnalysis<MemoryDependenceAnalysis>(F),
+                             S.MemDeps[I]);
+  }
+
+  mOutput.assign(S.Functions.size(), std::string());
+  S.Output = &mOutput;
+
+  WorkStealingPool Pool(NumThreads);
+  for (unsigned W = 0; W != Pool.getNumWorkers(); ++W)
+    S.Workers.push_back(new WorkerGraphs());
+
+  /*
+   * Workers bump statistics, store cached graphs and record trace events.
+   * Statistics register themselves at their first update and managed
+   * statics are created at their first use, both under a lock only in
+   * multithreaded mode; the trace writer is created here anyway, before
+   * workers can race to do it. The mode is left once the workers are done,
+   * so that the passes after this one run as they would without it.
+   */
+  bool StartedThreads = !llvm_is_multithreaded() && llvm_start_multithreaded();
+  initializeTrace();
+
+  Pool.run(S.Tasks.size(), buildFunctionGraphs, &S);
+
+  // Functions whose cached file could not be loaded are built in a second
+  // round.
+  S.Tasks.clear();
+  if (UseCache)
+    for (unsigned I = 0, E = S.Functions.size(); I != E; ++I)
+      if (S.Failed[I])
+      {
+        Function &F = *S.Functions[I];
+        TraceEvent Trace("Memory dependences", F.getName());
+        collectMemoryDependences(F, AA,
+                                 getAnalysis<MemoryDependenceAnalysis>(F),
+                                 S.MemDeps[I]);
+        S.Tasks.push_back(I);
+      }
+  if (!S.Tasks.empty())
+    Pool.run(S.Tasks.size(), buildFunctionGraphs, &S);
+
+  if (StartedThreads)
+    llvm_stop_multithreaded();
+
+  for (unsigned W = 0; W != S.Workers.size(); ++W)
+    delete S.Workers[W];
+  return false;
+}
+
+
+void ParallelDependencyGraphs::getAnalysisUsage(AnalysisUsage &AU) const
+{
+  AU.addRequired<AliasAnalysis>();
+  AU.addRequired<MemoryDependenceAnalysis>();
+  AU.setPreservesAll();
+}
+
+
+void ParallelDependencyGraphs::print(raw_ostream &OS, const Module*) const
+{
+  for (std::vector<std::string>::const_iterator I = mOutput.begin(),
+         E = mOutput.end(); I != E; ++I)
+    OS << *I;
+}
+
+
+ParallelDependencyGraphs *cot::CreateParallelDependencyGraphsPass()
+{
+  return new ParallelDependencyGraphs();
+}
+
+
+INITIALIZE_PASS(ParallelDependencyGraphs, "parallel-dg",
+                "Parallel Dependency Graphs Construction",
+                true,
+                true)
@@ -0,0 +1,155 @@
+/** ---*- C++ -*--- PostDominanceFrontier.cpp
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "cot/DependencyGraph/PostDominanceFrontier.h"
+
+#include "cot/AllPasses.h"
+#include "llvm/Function.h"
+#include "llvm/Assembly/Writer.h"
+#include "llvm/Analysis/PostDominators.h"
+#include "llvm/Support/CFG.h"
+#include "llvm/Support/raw_ostream.h"
+
+
+using namespace cot;
+using namespace llvm;
+
+
+char PostDominanceFrontier::ID = 0;
+
+
+bool PostDominanceFrontier::runOnFunction(Function &F)
+{
+  PostDominatorTree &PDT = getAnalysis<PostDominatorTree>();
+  calculate(F, *PDT.DT);
+  return false;
+}
+
+
+void PostDominanceFrontier::calculate(Function &F,
+                                      DominatorTreeBase<BasicBlock> &PDT)
+{
+  mBlockIdx.clear();
+  mBlocks.clear();
+  for (Function::iterator I = F.begin(), E = F.end(); I != E; ++I)
+  {
+    mBlockIdx[I] = mBlocks.size();
+    mBlocks.push_back(I);
+  }
+  unsigned NumBlocks = mBlocks.size();
+
+  /*
+   * For each edge Y->S, every block on the post-dominator tree path from S up
+   * to the immediate post-dominator of Y (excluded) has Y in its frontier. If
+   * a walk for Y reaches a block whose frontier already got Y, the rest of the
+   * path has been visited by a previous walk for Y, so we can stop there.
+   */
+  std::vector<std::pair<unsigned, BasicBlock *> > Members;
+  std::vector<BasicBlock *> LastAdded(NumBlocks, static_cast<BasicBlock *>(0));
+  std::vector<unsigned> Count(NumBlocks + 1, 0);
+  for (unsigned Y = 0; Y != NumBlocks; ++Y)
+  {
+    BasicBlock *YBB = mBlocks[Y];
+    DomTreeNode *YNode = PDT.getNode(YBB);
+    if (!YNode)
+      continue;
+    DomTreeNode *IPDom = YNode->getIDom();
+
+    for (succ_iterator SI = succ_begin(YBB), SE = succ_end(YBB); SI != SE; ++SI)
+    {
+      DomTreeNode *Runner = PDT.getNode(*SI);
+      while (Runner && Runner != IPDom && Runner->getBlock())
+      {
+        unsigned X = mBlockIdx[Runner->getBlock()];
+        if (LastAdded[X] == YBB)
+          break;
+        LastAdded[X] = YBB;
+        Members.push_back(std::make_pair(X, YBB));
+        ++Count[X + 1];
+        Runner = Runner->getIDom();
+      }
+    }
+  }
+
+  // Group by block. Members are already in function order of the frontier
+  // blocks, and the counting sort is stable.
+  mBegin.assign(NumBlocks + 1, 0);
+  for (unsigned X = 0; X != NumBlocks; ++X)
+    mBegin[X + 1] = mBegin[X] + Count[X + 1];
+  mFrontiers.resize(Members.size());
+  std::vector<unsigned> Pos(mBegin.begin(), mBegin.end() - 1);
+  for (unsigned I = 0, E = Members.size(); I != E; ++I)
+    mFrontiers[Pos[Members[I].first]++] = Members[I].second;
+}
+
+
+PostDominanceFrontier::iterator
+PostDominanceFrontier::frontier_begin(const BasicBlock *BB) const
+{
+  BlockIndexMap::const_iterator I = mBlockIdx.find(BB);
+  if (I == mBlockIdx.end() || mFrontiers.empty())
+    return 0;
+  return &mFrontiers[0] + mBegin[I->second];
+}
+
+
+PostDominanceFrontier::iterator
+PostDominanceFrontier::frontier_end(const BasicBlock *BB) const
+{
+  BlockIndexMap::const_iterator I = mBlockIdx.find(BB);
+  if (I == mBlockIdx.end() || mFrontiers.empty())
+    return 0;
+  return &mFrontiers[0] + mBegin[I->second + 1];
+}
+
+
+void PostDominanceFrontier::getAnalysisUsage(AnalysisUsage &AU) const
+{
+  AU.setPreservesAll();
+  AU.addRequired<PostDominatorTree>();
+}
+
+
+void PostDominanceFrontier::print(raw_ostream &OS, const Module*) const
+{
+  for (std::vector<BasicBlock *>::const_iterator I = mBlocks.begin(),
+         E = mBlocks.end(); I != E; ++I)
+  {
+    OS << "  PostDomFrontier for BB ";
+    WriteAsOperand(OS, *I, false);
+    OS << " is:";
+    for (iterator FI = frontier_begin(*I), FE = frontier_end(*I); FI != FE; ++FI)
+    {
+      OS << ' ';
+      WriteAsOperand(OS, *FI, false);
+    }
+    OS << "\n";
+  }
+}
+
+
+PostDominanceFrontier *cot::CreatePostDominanceFrontierPass()
+{
+  return new PostDominanceFrontier();
+}
+
+
+INITIALIZE_PASS(PostDominanceFrontier, "postdomfrontier",
+                "Post-Dominance Frontier Construction",
+                true,
+                true)
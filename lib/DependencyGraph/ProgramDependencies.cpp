@@ -16,13 +16,16 @@
  * along with this program.  If not, see http://www.gnu.org/licenses/.
  */
 
-
+#define DEBUG_TYPE "pdg"
 #include "cot/DependencyGraph/ProgramDependencies.h"
 #include "cot/DependencyGraph/DataDependencies.h"
 #include "cot/DependencyGraph/ControlDependencies.h"
 
 #include "cot/AllPasses.h"
+#include "cot/DependencyGraph/DependencyLayers.h"
+#include "cot/Support/PhaseTimer.h"
 #include "llvm/Function.h"
+#include "llvm/ADT/Statistic.h"
 #include "llvm/Support/raw_ostream.h"
 
 
@@ -30,32 +33,50 @@ using namespace cot;
 using namespace llvm;
 
 
+STATISTIC(NumPDGNodes, "Number of nodes of program dependency graphs");
+STATISTIC(NumPDGControlEdges,
+          "Number of control links of program dependency graphs");
+STATISTIC(NumPDGDataEdges, "Number of data links of program dependency graphs");
+
+
+static void updateStatistics(const DepGraphView &PDG)
+{
+  NumPDGNodes += PDG.getNumNodes();
+  NumPDGControlEdges += PDG.getNumEdges(CONTROL);
+  NumPDGDataEdges += PDG.getNumEdges(DATA);
+}
+
+
+void cot::buildProgramDependencies(Function &F,
+                                   DominatorTreeBase<BasicBlock> &PDT,
+                                   const MemoryDependences &Deps,
+                                   ProgramDepGraph &PDG)
+{
+  PDG.clear();
+  addControlDependencies(F, PDT, PDG);
+  addDataDependencies(F, Deps, PDG);
+  PDG.freeze(F.begin(), F.end());
+  updateStatistics(DepGraphView(PDG, ControlTypeMask | DataTypeMask));
+}
+
+
 char ProgramDependencyGraph::ID = 0;
 
 
 bool ProgramDependencyGraph::runOnFunction(Function &F)
 {
-  DataDepGraph* DDG = getAnalysis<DataDependencyGraph>().DDG;
-  DataDepGraph* CDG = getAnalysis<ControlDependencyGraph>().CDG;
-
-  for (Function::BasicBlockListType::const_iterator it = F.getBasicBlockList().begin(); it != F.getBasicBlockList().end(); ++it)
-  {
-    if (CDG->depends(CDG->getRootNode()->getData(), &*it ))
-      PDG->addDependency(static_cast<BasicBlock *>(0), &*it, CONTROL);
-    for (Function::BasicBlockListType::const_iterator it2 = F.getBasicBlockList().begin(); it2 != F.getBasicBlockList().end(); ++it2)
-    {
-      if(DDG->depends(&*it, &*it2))
-        PDG->addDependency(&*it, &*it2, DATA);
-      if(CDG->depends(&*it, &*it2))
-        PDG->addDependency(&*it, &*it2, CONTROL);
-    }
-  }
+  TraceEvent Trace(getPassName(), F.getName());
+  // The required analyses added both layers to the shared graph.
+  DependencyLayers &Layers = getAnalysis<DependencyLayers>();
+  PDG = Layers.getView(ControlTypeMask | DataTypeMask);
+  updateStatistics(PDG);
   return false;
 }
 
 
 void ProgramDependencyGraph::getAnalysisUsage(AnalysisUsage &AU) const
 {
+  AU.addRequiredTransitive<DependencyLayers>();
   AU.addRequired<DataDependencyGraph>();
   AU.addRequired<ControlDependencyGraph>();
   AU.setPreservesAll();
@@ -65,7 +86,8 @@ void ProgramDependencyGraph::getAnalysisUsage(AnalysisUsage &AU) const
 
 void ProgramDependencyGraph::print(llvm::raw_ostream &OS, const llvm::Module*) const
 {
-  PDG->print(OS, getPassName());
+  PhaseTimer Phase("Printing", StringRef());
+  PDG.print(OS, getPassName());
 }
 
 ProgramDependencyGraph *CreateProgramDependencyGraphPass()
@@ -0,0 +1,313 @@
+/** ---*- C++ -*--- QueryPrinters.cpp
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "cot/AllPasses.h"
+#include "cot/DependencyGraph/DependencyLayers.h"
+#include "cot/DependencyGraph/DependencyQueries.h"
+#include "cot/DependencyGraph/Reachability.h"
+#include "llvm/Function.h"
+#include "llvm/Pass.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+
+#include <algorithm>
+#include <vector>
+
+
+using namespace cot;
+using namespace llvm;
+
+
+static cl::opt<unsigned>
+MaxMatrixComponents("dg-reaches-max-matrix",
+                    cl::desc("Largest number of components whose closure "
+                             "-dg-reaches stores as a bit matrix"),
+                    cl::init(unsigned(DependencyReachability<>::
+                                        DefaultMaxMatrixComponents)));
+
+namespace {
+enum LinkSearchKind
+{
+  AutoSearch,
+  SortedSearch,
+  LinearSearch,
+  BitsetSearch
+};
+}
+
+static cl::opt<LinkSearchKind>
+QuerySearch("dg-queries-search",
+            cl::desc("How -dg-queries searches the links of a node"),
+            cl::values(clEnumValN(AutoSearch, "auto",
+                                  "Linear scan for control links alone, "
+                                  "binary search otherwise"),
+                       clEnumValN(SortedSearch, "sorted", "Binary search"),
+                       clEnumValN(LinearSearch, "linear", "Linear scan"),
+                       clEnumValN(BitsetSearch, "bitset",
+                                  "Adjacency bit matrix"),
+                       clEnumValEnd),
+            cl::init(AutoSearch));
+
+static cl::opt<unsigned>
+QueryMemoSize("dg-queries-memo",
+              cl::desc("Number of answers -dg-queries keeps in its memo"),
+              cl::init(4));
+
+
+/// Print the label of node From and those of the nodes set in Targets.
+static void writeLinks(raw_ostream &OS, const DepGraph &G, uint32_t From,
+                       const BitVector &Targets)
+{
+  OS.indent(4);
+  WriteNodeLabel(OS, G.getNode(From));
+  OS << " { ";
+  for (int To = Targets.find_first(); To != -1; To = Targets.find_next(To))
+  {
+    WriteNodeLabel(OS, G.getNode(To));
+    OS << " ";
+  }
+  OS << "}\n";
+}
+
+
+/*!
+ * Printers of the answers the query structures of frozen graphs give on the
+ * graph shared through DependencyLayers, holding the layers built so far.
+ * They print the graph as it is when printing, so that running one again
+ * after another analysis shows how the graph changed.
+ */
+namespace cot
+{
+namespace {
+class DependencyQueryPrinter : public FunctionPass
+{
+public:
+  DependencyQueryPrinter(char &ID) : FunctionPass(ID), mLayers(0) { }
+
+  bool runOnFunction(Function &F)
+  {
+    mLayers = &getAnalysis<DependencyLayers>();
+    return false;
+  }
+
+  void getAnalysisUsage(AnalysisUsage &AU) const
+  {
+    AU.addRequiredTransitive<DependencyLayers>();
+    AU.setPreservesAll();
+  }
+
+  void print(raw_ostream &OS, const Module*) const
+  {
+    if (!mLayers || !mLayers->getGraph().isFrozen())
+    {
+      OS << "No dependency layer built for this function\n";
+      return;
+    }
+    printGraph(OS, mLayers->getGraph());
+  }
+
+protected:
+  virtual void printGraph(raw_ostream &OS, const DepGraph &G) const = 0;
+
+  const DependencyLayers &getLayers() const { return *mLayers; }
+
+private:
+  DependencyLayers *mLayers;
+};
+
+
+/// Print the nodes each node reaches, that is those transitively depending
+/// on it, itself included.
+struct ReachabilityPrinter : public DependencyQueryPrinter
+{
+  static char ID;
+  ReachabilityPrinter() : DependencyQueryPrinter(ID) { }
+
+  void printGraph(raw_ostream &OS, const DepGraph &G) const
+  {
+    DependencyReachability<> Reach(G, MaxMatrixComponents);
+    OS << "Reachability of the dependency graph ("
+       << (Reach.usesMatrix() ? "bit matrix" : "interval labels") << "):\n";
+    for (uint32_t From = 0, E = G.getNumNodes(); From != E; ++From)
+    {
+      OS.indent(4);
+      WriteNodeLabel(OS, G.getNode(From));
+      OS << " { ";
+      for (uint32_t To = 0; To != E; ++To)
+        if (Reach.reaches(From, To))
+        {
+          WriteNodeLabel(OS, G.getNode(To));
+          OS << " ";
+        }
+      OS << "}\n";
+    }
+  }
+};
+
+
+/// Print the strongly connected components of the graph, in their order,
+/// along with their level and whether they hold a cycle.
+struct ComponentsPrinter : public DependencyQueryPrinter
+{
+  static char ID;
+  ComponentsPrinter() : DependencyQueryPrinter(ID) { }
+
+  void printGraph(raw_ostream &OS, const DepGraph &G) const
+  {
+    const DependencyComponents &C = G.getComponents();
+    OS << "Components of the dependency graph: " << C.getNumComponents()
+       << " components, " << C.getNumLevels() << " levels\n";
+    for (uint32_t Comp = 0, E = C.getNumComponents(); Comp != E; ++Comp)
+    {
+      OS.indent(4) << Comp << " { ";
+      for (const uint32_t *M = C.members_begin(Comp),
+             *ME = C.members_end(Comp); M != ME; ++M)
+      {
+        WriteNodeLabel(OS, G.getNode(*M));
+        OS << " ";
+      }
+      OS << "} level " << C.getLevel(Comp);
+      if (C.isCyclic(Comp))
+        OS << ", cyclic";
+      OS << "\n";
+    }
+  }
+};
+
+
+/*!
+ * Print the links of the graph as found by DependencyQueries: asked all in
+ * one batch, from one node to many, and one at a time through the memo.
+ * Targets are asked in decreasing order, so that batches have to sort them.
+ * Point queries are asked twice in a row, then the last -dg-queries-memo
+ * ones again and the first one again; the hits and misses of the memo
+ * follow. Links are searched with the policy -dg-queries-search names; by
+ * default, the graph of the control layer alone, with a few links per
+ * node, is scanned linearly.
+ */
+struct QueriesPrinter : public DependencyQueryPrinter
+{
+  static char ID;
+  QueriesPrinter() : DependencyQueryPrinter(ID) { }
+
+  void printGraph(raw_ostream &OS, const DepGraph &G) const
+  {
+    LinkSearchKind Search = QuerySearch;
+    if (Search == AutoSearch)
+      Search = getLayers().hasLayer(DATA) ? SortedSearch : LinearSearch;
+
+    switch (Search)
+    {
+    case AutoSearch:
+    case SortedSearch:
+      OS << "Queries with sorted link search:\n";
+      printQueries<SortedLinkSearch>(OS, G);
+      break;
+    case LinearSearch:
+      OS << "Queries with linear link search:\n";
+      printQueries<LinearLinkSearch>(OS, G);
+      break;
+    case BitsetSearch:
+      OS << "Queries with bitset link search:\n";
+      printQueries<BitsetLinkSearch>(OS, G);
+      break;
+    }
+  }
+
+  template <class SearchT>
+  void printQueries(raw_ostream &OS, const DepGraph &G) const
+  {
+    typedef DependencyQueries<BasicBlock, SearchT> Queries;
+    uint32_t NumNodes = G.getNumNodes();
+    Queries Q(G, QueryMemoSize);
+    BitVector Targets(NumNodes);
+
+    std::vector<typename Queries::Query> Batch;
+    std::vector<uint32_t> IDs;
+    for (uint32_t From = 0; From != NumNodes; ++From)
+      for (uint32_t To = NumNodes; To-- != 0; )
+        Batch.push_back(typename Queries::Query(From, To));
+    for (uint32_t To = NumNodes; To-- != 0; )
+      IDs.push_back(To);
+
+    OS << "Batch answers:\n";
+    const BitVector &Answers = Q.dependsBatch(Batch.begin(), Batch.end());
+    for (uint32_t From = 0; From != NumNodes; ++From)
+    {
+      Targets.reset();
+      for (uint32_t I = 0; I != NumNodes; ++I)
+        if (Answers.test(From * NumNodes + I))
+          Targets.set(IDs[I]);
+      writeLinks(OS, G, From, Targets);
+    }
+
+    OS << "One-to-many answers:\n";
+    for (uint32_t From = 0; From != NumNodes; ++From)
+    {
+      const BitVector &Many = Q.dependsManyBatch(From, IDs.begin(), IDs.end());
+      Targets.reset();
+      for (uint32_t I = 0; I != NumNodes; ++I)
+        if (Many.test(I))
+          Targets.set(IDs[I]);
+      writeLinks(OS, G, From, Targets);
+    }
+
+    OS << "Point answers:\n";
+    for (uint32_t From = 0; From != NumNodes; ++From)
+    {
+      const BasicBlock *FromBB = G.getNode(From)->getData();
+      Targets.reset();
+      for (uint32_t To = NumNodes; To-- != 0; )
+      {
+        const BasicBlock *ToBB = G.getNode(To)->getData();
+        Q.getLinkTypes(FromBB, ToBB);
+        if (Q.depends(FromBB, ToBB))
+          Targets.set(To);
+      }
+      writeLinks(OS, G, From, Targets);
+    }
+
+    uint32_t NumPairs = Batch.size();
+    for (uint32_t I = NumPairs - std::min<uint32_t>(QueryMemoSize, NumPairs);
+         I != NumPairs; ++I)
+      Q.getLinkTypes(G.getNode(Batch[I].first)->getData(),
+                     G.getNode(Batch[I].second)->getData());
+    Q.getLinkTypes(G.getNode(Batch.front().first)->getData(),
+                   G.getNode(Batch.front().second)->getData());
+    OS << "Memo of " << QueryMemoSize << " answers: " << Q.getNumHits()
+       << " hits, " << Q.getNumMisses() << " misses\n";
+  }
+};
+}
+}
+
+
+char ReachabilityPrinter::ID = 0;
+INITIALIZE_PASS(ReachabilityPrinter, "dg-reaches",
+                "Dependency Graph Reachability",
+                true, true)
+
+char ComponentsPrinter::ID = 0;
+INITIALIZE_PASS(ComponentsPrinter, "dg-components",
+                "Dependency Graph Components",
+                true, true)
+
+char QueriesPrinter::ID = 0;
+INITIALIZE_PASS(QueriesPrinter, "dg-queries",
+                "Dependency Graph Queries",
+                true, true)
@@ -0,0 +1,272 @@
+/** ---*- C++ -*--- Slicing.cpp
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "cot/DependencyGraph/Slicing.h"
+
+#include "cot/AllPasses.h"
+#include "cot/DependencyGraph/ControlDependencies.h"
+#include "cot/DependencyGraph/DataDependencies.h"
+#include "cot/DependencyGraph/LazyDependencies.h"
+#include "cot/DependencyGraph/ProgramDependencies.h"
+#include "llvm/Function.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/MemoryDependenceAnalysis.h"
+#include "llvm/ADT/DepthFirstIterator.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/raw_ostream.h"
+
+
+using namespace cot;
+using namespace llvm;
+
+
+static cl::list<std::string>
+Criteria("pdg-slice-criterion",
+         cl::desc("Blocks or instructions to slice the program from"),
+         cl::value_desc("name"),
+         cl::CommaSeparated);
+
+static cl::opt<SliceDirection>
+Direction("pdg-slice-direction",
+          cl::desc("Direction of the program slice"),
+          cl::values(clEnumValN(BackwardSlice, "backward",
+                                "What the criteria depend on"),
+                     clEnumValN(ForwardSlice, "forward",
+                                "What depends on the criteria"),
+                     clEnumValEnd),
+          cl::init(BackwardSlice));
+
+static cl::opt<bool>
+Lazy("pdg-slice-lazy",
+     cl::desc("Slice blocks on the lazy program dependency graph"),
+     cl::init(false));
+
+static cl::opt<bool>
+UseGraphTraits("pdg-slice-graph-traits",
+               cl::desc("Slice blocks with depth-first iterators over the "
+                        "graph traits, as a check of the slicer"),
+               cl::init(false));
+
+
+void cot::nameValues(Function &F, StringMap<const Value *> &Names)
+{
+  unsigned Slot = 0;
+  for (Function::arg_iterator A = F.arg_begin(), E = F.arg_end(); A != E; ++A)
+    if (!A->hasName())
+      ++Slot;
+
+  for (Function::iterator BB = F.begin(), E = F.end(); BB != E; ++BB)
+  {
+    if (BB->hasName())
+      Names[BB->getName()] = &*BB;
+    else
+      Names[utostr(Slot++)] = &*BB;
+
+    for (BasicBlock::iterator I = BB->begin(), IE = BB->end(); I != IE; ++I)
+      if (I->hasName())
+        Names[I->getName()] = &*I;
+      else if (!I->getType()->isVoidTy())
+        Names[utostr(Slot++)] = &*I;
+  }
+}
+
+
+/*!
+ * Slice G from the node IDs in IDs as DependencySlicer does, walking its
+ * links with df_iterator, or with idf_iterator over the reverse links for
+ * backward slices. The program dependency graph has no link outside of the
+ * view, so every link is followed.
+ */
+static const BitVector &traverse(const DepGraph &G,
+                                 const std::vector<uint32_t> &IDs,
+                                 BitVector &Slice)
+{
+  Slice.resize(G.getNumNodes());
+  for (std::vector<uint32_t>::const_iterator I = IDs.begin(), E = IDs.end();
+       I != E; ++I)
+  {
+    DepGraphNode *N = const_cast<DepGraphNode *>(G.getNode(*I));
+    if (Direction == BackwardSlice)
+      for (idf_iterator<DepGraphNode *> NI = idf_begin(N), NE = idf_end(N);
+           NI != NE; ++NI)
+        Slice.set(NI->getID());
+    else
+      for (df_iterator<DepGraphNode *> NI = df_begin(N), NE = df_end(N);
+           NI != NE; ++NI)
+        Slice.set(NI->getID());
+  }
+  return Slice;
+}
+
+
+char ProgramSlicing::ID = 0;
+
+
+bool ProgramSlicing::runOnFunction(Function &F)
+{
+  mSlice.clear();
+  mFoundCriterion = false;
+
+  StringMap<const Value *> Names;
+  nameValues(F, Names);
+
+  std::vector<const BasicBlock *> Blocks;
+  std::vector<const Instruction *> Insts;
+  for (cl::list<std::string>::const_iterator C = Criteria.begin(),
+         CE = Criteria.end(); C != CE; ++C)
+  {
+    StringRef Name(*C);
+    if (Name.startswith("%"))
+      Name = Name.substr(1);
+    StringMap<const Value *>::const_iterator V = Names.find(Name);
+    if (V == Names.end())
+      continue;
+    if (const BasicBlock *BB = dyn_cast<BasicBlock>(V->second))
+      Blocks.push_back(BB);
+    else
+      Insts.push_back(cast<Instruction>(V->second));
+  }
+  if (Blocks.empty() && Insts.empty())
+    return false;
+  mFoundCriterion = true;
+
+  std::vector<uint32_t> IDs;
+  if (Insts.empty() && Lazy)
+  {
+    LazyDependencyGraph &LPDG = getAnalysis<LazyProgramDependencyGraph>().LPDG;
+    for (std::vector<const BasicBlock *>::const_iterator B = Blocks.begin(),
+           BE = Blocks.end(); B != BE; ++B)
+      IDs.push_back(LPDG.getID(*B));
+
+    const BitVector &Slice = LPDG.slice(IDs.begin(), IDs.end(), Direction);
+    for (int ID = Slice.find_first(); ID != -1; ID = Slice.find_next(ID))
+      if (const BasicBlock *BB = LPDG.getBlock(ID))
+        mSlice.push_back(BB);
+    return false;
+  }
+
+  if (Insts.empty())
+  {
+    const DepGraphView &PDG = getAnalysis<ProgramDependencyGraph>().PDG;
+    for (std::vector<const BasicBlock *>::const_iterator B = Blocks.begin(),
+           BE = Blocks.end(); B != BE; ++B)
+      IDs.push_back(PDG.getNodeByData(*B)->getID());
+
+    DependencySlicer<BasicBlock> Slicer(PDG.getGraph());
+    BitVector Traversed;
+    const BitVector &Slice = UseGraphTraits ?
+      traverse(PDG.getGraph(), IDs, Traversed) :
+      Slicer.slice(IDs.begin(), IDs.end(), Direction, PDG.getTypeMask());
+    for (int ID = Slice.find_first(); ID != -1; ID = Slice.find_next(ID))
+    {
+      const DepGraphNode *N = PDG.getGraph().getNode(ID);
+      if (!N->isSynthetic())
+        mSlice.push_back(N->getData());
+    }
+    return false;
+  }
+
+  MemoryDependences Deps;
+  collectMemoryDependences(F, getAnalysis<AliasAnalysis>(),
+                           getAnalysis<MemoryDependenceAnalysis>(), Deps);
+  if (Lazy)
+  {
+    LazyDependencyGraph &LPDG = getAnalysis<LazyProgramDependencyGraph>().LPDG;
+    LPDG.getControlDependencies(mLazyCDG);
+    buildInstructionDependencies(F, Deps,
+                                 DepGraphView(mLazyCDG, ControlTypeMask),
+                                 mIDG);
+  }
+  else
+    buildInstructionDependencies(F, Deps,
+                                 getAnalysis<ControlDependencyGraph>().CDG,
+                                 mIDG);
+
+  for (std::vector<const BasicBlock *>::const_iterator B = Blocks.begin(),
+         BE = Blocks.end(); B != BE; ++B)
+    for (BasicBlock::const_iterator I = (*B)->begin(), IE = (*B)->end();
+         I != IE; ++I)
+      Insts.push_back(&*I);
+  for (std::vector<const Instruction *>::const_iterator I = Insts.begin(),
+         IE = Insts.end(); I != IE; ++I)
+    IDs.push_back(mIDG.getNodeByData(*I)->getID());
+
+  DependencySlicer<Instruction> Slicer(mIDG);
+  const BitVector &Slice = Slicer.slice(IDs.begin(), IDs.end(), Direction);
+  for (int ID = Slice.find_first(); ID != -1; ID = Slice.find_next(ID))
+    if (const Instruction *I = mIDG.getNode(ID)->getData())
+      mSlice.push_back(I);
+  return false;
+}
+
+
+void ProgramSlicing::getAnalysisUsage(AnalysisUsage &AU) const
+{
+  AU.addRequiredTransitive<AliasAnalysis>();
+  AU.addRequiredTransitive<MemoryDependenceAnalysis>();
+  if (Lazy)
+    AU.addRequired<LazyProgramDependencyGraph>();
+  else
+  {
+    AU.addRequired<ControlDependencyGraph>();
+    AU.addRequired<ProgramDependencyGraph>();
+  }
+  AU.setPreservesAll();
+}
+
+
+void ProgramSlicing::print(raw_ostream &OS, const Module*) const
+{
+  if (!mFoundCriterion)
+  {
+    OS << "No slicing criterion in this function\n";
+    return;
+  }
+
+  OS << (Direction == BackwardSlice ? "Backward" : "Forward") << " slice of";
+  for (cl::list<std::string>::const_iterator C = Criteria.begin(),
+         CE = Criteria.end(); C != CE; ++C)
+    OS << ' ' << *C;
+  OS << ":\n";
+
+  for (std::vector<const Value *>::const_iterator V = mSlice.begin(),
+         VE = mSlice.end(); V != VE; ++V)
+  {
+    if (const Instruction *I = dyn_cast<Instruction>(*V))
+    {
+      OS.indent(2) << *I << '\n';
+      continue;
+    }
+    OS.indent(4);
+    WriteAsOperand(OS, *V, false);
+    OS << '\n';
+  }
+}
+
+
+ProgramSlicing *cot::CreateProgramSlicingPass()
+{
+  return new ProgramSlicing();
+}
+
+
+INITIALIZE_PASS(ProgramSlicing, "pdg-slice",
+                "Program Dependency Graph Slicing",
+                true,
+                true)
@@ -0,0 +1,177 @@
+/** ---*- C++ -*--- PhaseTimer.cpp
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "cot/Support/PhaseTimer.h"
+
+#include "llvm/Pass.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/Mutex.h"
+#include "llvm/Support/MutexGuard.h"
+#include "llvm/Support/TimeValue.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace cot;
+using namespace llvm;
+
+
+static cl::opt<std::string>
+TraceFile("dg-trace-file",
+          cl::desc("Write a Chrome trace of the phases of dependency "
+                   "analyses to this file"),
+          cl::value_desc("filename"),
+          cl::init(""));
+
+static const char *const TimerGroupName = "Dependency Graph Construction";
+
+
+namespace {
+
+/*!
+ * The trace file, opened at the first event and closed at shutdown. Events
+ * are written as soon as they end, so the trace stays valid for the trace
+ * viewer even if the closing bracket is never written.
+ */
+class TraceWriter
+{
+public:
+  TraceWriter() : mBase(getTime()), mFirst(true), mFailed(false) { }
+
+  ~TraceWriter()
+  {
+    if (mOS)
+      *mOS << "\n]\n";
+  }
+
+  /// Microseconds since the writer was created.
+  uint64_t now() const
+  {
+    return getTime() - mBase;
+  }
+
+  void write(StringRef Name, StringRef Function, unsigned Thread,
+             uint64_t Start, uint64_t End)
+  {
+    MutexGuard Guard(mLock);
+    if (!open())
+      return;
+
+    raw_ostream &OS = *mOS;
+    OS << (mFirst ? "[\n" : ",\n");
+    mFirst = false;
+    OS << "{\"name\":";
+    writeString(Name);
+    OS << ",\"cat\":\"dg\",\"ph\":\"X\",\"pid\":1,\"tid\":" << Thread
+       << ",\"ts\":" << Start << ",\"dur\":" << End - Start;
+    if (!Function.empty())
+    {
+      OS << ",\"args\":{\"function\":";
+      writeString(Function);
+      OS << '}';
+    }
+    OS << '}';
+  }
+
+private:
+  static uint64_t getTime()
+  {
+    sys::TimeValue Now = sys::TimeValue::now();
+    return uint64_t(Now.seconds()) * 1000000 + Now.microseconds();
+  }
+
+  bool open()
+  {
+    if (mOS || mFailed)
+      return !mFailed;
+
+    std::string ErrorInfo;
+    mOS.reset(new raw_fd_ostream(TraceFile.c_str(), ErrorInfo));
+    if (ErrorInfo.empty())
+      return true;
+    errs() << "Error opening trace file '" << TraceFile << "': " << ErrorInfo
+           << "\n";
+    mOS.reset();
+    mFailed = true;
+    return false;
+  }
+
+  void writeString(StringRef S)
+  {
+    raw_ostream &OS = *mOS;
+    OS << '"';
+    for (StringRef::iterator I = S.begin(), E = S.end(); I != E; ++I)
+    {
+      unsigned char C = *I;
+      if (C == '"' || C == '\\')
+        OS << '\\' << C;
+      else if (C < 0x20)
+        OS << format("\\u%04x", C);
+      else
+        OS << C;
+    }
+    OS << '"';
+  }
+
+  sys::Mutex mLock;
+  OwningPtr<raw_fd_ostream> mOS;
+  uint64_t mBase;
+  bool mFirst;
+  bool mFailed;
+};
+
+ManagedStatic<TraceWriter> Writer;
+
+} // End anonymous namespace.
+
+
+bool cot::isTraceEnabled()
+{
+  return !TraceFile.empty();
+}
+
+
+void cot::initializeTrace()
+{
+  if (isTraceEnabled())
+    Writer->now();
+}
+
+
+TraceEvent::TraceEvent(StringRef Name, StringRef Function, unsigned Thread) :
+mName(Name), mFunction(Function), mThread(Thread), mStart(0),
+mEnabled(isTraceEnabled())
+{
+  if (mEnabled)
+    mStart = Writer->now();
+}
+
+
+TraceEvent::~TraceEvent()
+{
+  if (mEnabled)
+    Writer->write(mName, mFunction, mThread, mStart, Writer->now());
+}
+
+
+PhaseTimer::PhaseTimer(StringRef Name, StringRef Function) :
+mTimer(Name, TimerGroupName, TimePassesIsEnabled),
+mEvent(Name, Function)
+{
+}
@@ -0,0 +1,182 @@
+/** ---*- C++ -*--- WorkStealingPool.cpp
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "cot/Support/WorkStealingPool.h"
+
+#include "llvm/Config/config.h"
+#include "llvm/Config/llvm-config.h"
+#include "llvm/Support/DataTypes.h"
+#include "llvm/Support/Mutex.h"
+#include "llvm/Support/MutexGuard.h"
+
+#if defined(LLVM_MULTITHREADED) && LLVM_MULTITHREADED && defined(HAVE_PTHREAD_H)
+#define COT_USE_PTHREADS 1
+#include <pthread.h>
+#include <unistd.h>
+#else
+#define COT_USE_PTHREADS 0
+#endif
+
+#include <vector>
+
+using namespace cot;
+using namespace llvm;
+
+
+namespace {
+
+// Tasks still owned by a worker: the owner pops from the front, thieves from
+// the back.
+struct TaskRange
+{
+  TaskRange() : Begin(0), End(0) { }
+
+  sys::Mutex Lock;
+  unsigned Begin;
+  unsigned End;
+};
+
+struct PoolState
+{
+  WorkStealingPool::TaskFn Fn;
+  void *Context;
+  std::vector<TaskRange *> Ranges;
+};
+
+struct WorkerArgs
+{
+  PoolState *State;
+  unsigned Worker;
+};
+
+bool popFront(TaskRange &R, unsigned &Task)
+{
+  MutexGuard Guard(R.Lock);
+  if (R.Begin == R.End)
+    return false;
+  Task = R.Begin++;
+  return true;
+}
+
+bool popBack(TaskRange &R, unsigned &Task)
+{
+  MutexGuard Guard(R.Lock);
+  if (R.Begin == R.End)
+    return false;
+  Task = --R.End;
+  return true;
+}
+
+void runWorker(PoolState &State, unsigned Worker)
+{
+  unsigned NumWorkers = State.Ranges.size();
+  unsigned Task;
+
+  for (;;)
+  {
+    while (popFront(*State.Ranges[Worker], Task))
+      State.Fn(State.Context, Task, Worker);
+
+    // Our range is empty: steal from the others, starting from the next
+    // worker so that thieves spread over victims.
+    bool Stolen = false;
+    for (unsigned I = 1; I != NumWorkers && !Stolen; ++I)
+      Stolen = popBack(*State.Ranges[(Worker + I) % NumWorkers], Task);
+    if (!Stolen)
+      return;
+    State.Fn(State.Context, Task, Worker);
+  }
+}
+
+#if COT_USE_PTHREADS
+void *workerMain(void *Arg)
+{
+  WorkerArgs *Args = static_cast<WorkerArgs *>(Arg);
+  runWorker(*Args->State, Args->Worker);
+  return 0;
+}
+#endif
+
+} // End anonymous namespace.
+
+
+WorkStealingPool::WorkStealingPool(unsigned NumWorkers)
+    : mNumWorkers(NumWorkers ? NumWorkers : getNumCores())
+{
+#if !COT_USE_PTHREADS
+  mNumWorkers = 1;
+#endif
+}
+
+
+void WorkStealingPool::run(unsigned NumTasks, TaskFn Fn, void *Context)
+{
+  unsigned NumWorkers = mNumWorkers < NumTasks ? mNumWorkers : NumTasks;
+  if (NumWorkers <= 1)
+  {
+    for (unsigned Task = 0; Task != NumTasks; ++Task)
+      Fn(Context, Task, 0);
+    return;
+  }
+
+  PoolState State;
+  State.Fn = Fn;
+  State.Context = Context;
+  for (unsigned W = 0; W != NumWorkers; ++W)
+  {
+    TaskRange *R = new TaskRange();
+    R->Begin = uint64_t(NumTasks) * W / NumWorkers;
+    R->End = uint64_t(NumTasks) * (W + 1) / NumWorkers;
+    State.Ranges.push_back(R);
+  }
+
+#if COT_USE_PTHREADS
+  std::vector<WorkerArgs> Args(NumWorkers);
+  std::vector<pthread_t> Threads(NumWorkers);
+  std::vector<bool> Started(NumWorkers, false);
+  for (unsigned W = 1; W != NumWorkers; ++W)
+  {
+    Args[W].State = &State;
+    Args[W].Worker = W;
+    Started[W] = !pthread_create(&Threads[W], 0, workerMain, &Args[W]);
+  }
+
+  // If a thread could not be created, its range is stolen by the others.
+  runWorker(State, 0);
+
+  for (unsigned W = 1; W != NumWorkers; ++W)
+    if (Started[W])
+      pthread_join(Threads[W], 0);
+#else
+  runWorker(State, 0);
+#endif
+
+  for (unsigned W = 0; W != NumWorkers; ++W)
+    delete State.Ranges[W];
+}
+
+
+unsigned WorkStealingPool::getNumCores()
+{
+#if COT_USE_PTHREADS && defined(_SC_NPROCESSORS_ONLN)
+  long NumCores = sysconf(_SC_NPROCESSORS_ONLN);
+  if (NumCores > 0)
+    return NumCores;
+#endif
+  return 1;
+}
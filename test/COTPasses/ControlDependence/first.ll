@@ -1,6 +1,13 @@
 ; RUN: opt -load %projshlibdir/COTPasses.so \
 ; RUN:     -analyze -cdg                    \
 ; RUN:     -S -o - %s | FileCheck %s
+; RUN: opt -load %projshlibdir/COTPasses.so \
+; RUN:     -analyze -cdg -cdg-use-pdf       \
+; RUN:     -S -o - %s | FileCheck %s
+; RUN: opt -load %projshlibdir/COTPasses.so \
+; RUN:     -analyze -cdg -cdg-threads=4     \
+; RUN:     -cdg-parallel-threshold=0        \
+; RUN:     -S -o - %s | FileCheck %s
 ; REQUIRES: loadable_module
 
 target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64-S128"
@@ -40,6 +47,6 @@ define i32 @first() nounwind uwtable {
 ;CHECK-NEXT:    <<EntryNode>> { %0:0 %1:0 %12:0 }
 ;CHECK-NEXT:    %0 { }
 ;CHECK-NEXT:    %1 { %4:0 %9:0 }
-;CHECK-NEXT:    %12 { }
 ;CHECK-NEXT:    %4 { }
 ;CHECK-NEXT:    %9 { }
+;CHECK-NEXT:    %12 { }
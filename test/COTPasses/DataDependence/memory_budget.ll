@@ -0,0 +1,58 @@
+; RUN: opt -load %projshlibdir/COTPasses.so                \
+; RUN:     -analyze -basicaa -ddg -ddg-memory-link-budget=1 \
+; RUN:     -S -o - %s | FileCheck %s
+; RUN: opt -load %projshlibdir/COTPasses.so                \
+; RUN:     -basicaa -ddg -ddg-memory-link-budget=1 -stats   \
+; RUN:     -disable-output %s 2>&1 | FileCheck --check-prefix=STATS %s
+; RUN: opt -load %projshlibdir/COTPasses.so                \
+; RUN:     -analyze -basicaa -ddg -ddg-memory-link-budget=1 \
+; RUN:     -ddg-alias-sets -S -o - %s                       \
+; RUN:     | FileCheck --check-prefix=ALIAS %s
+; REQUIRES: loadable_module
+
+target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define void @budget(i32 %c) nounwind uwtable {
+  %a = alloca i32, align 4
+  %b = alloca i32, align 4
+  store i32 0, i32* %a, align 4
+  store i32 0, i32* %b, align 4
+  %cond = icmp ne i32 %c, 0
+  br i1 %cond, label %1, label %2
+
+; <label>:1                                       ; preds = %0
+  store i32 1, i32* %a, align 4
+  br label %3
+
+; <label>:2                                       ; preds = %0
+  store i32 1, i32* %b, align 4
+  br label %3
+
+; <label>:3                                       ; preds = %2, %1
+  store i32 2, i32* %a, align 4
+  ret void
+}
+
+; The store of %3 depends on %0 and %1, over the budget: both link to the
+; memory state node instead, which links to %3. The link from %0 to %3 is
+; left for the use of %a.
+;CHECK:      Printing analysis 'Data Dependency Graph Construction' for function 'budget':
+;CHECK-NEXT: =============================--------------------------------
+;CHECK-NEXT: Data Dependency Graph: 
+;CHECK-NEXT:    %0 { %1:1 %2:1 %3:1 <<MemoryState>>:1 }
+;CHECK-NEXT:    %1 { <<MemoryState>>:1 }
+;CHECK-NEXT:    %2 { }
+;CHECK-NEXT:    %3 { }
+;CHECK-NEXT:    <<MemoryState>> { %3:1 }
+
+;STATS: 1 ddg - Number of blocks whose memory links were summarized
+
+; With alias sets, every block but %2 depends on two others through %a or
+; %b, so only the link from %0 to %2 is left out of the summary.
+;ALIAS:      Data Dependency Graph: 
+;ALIAS-NEXT:    %0 { %1:1 %2:1 %3:1 <<MemoryState>>:1 }
+;ALIAS-NEXT:    %1 { <<MemoryState>>:1 }
+;ALIAS-NEXT:    %2 { <<MemoryState>>:1 }
+;ALIAS-NEXT:    %3 { <<MemoryState>>:1 }
+;ALIAS-NEXT:    <<MemoryState>> { %0:1 %1:1 %3:1 }
@@ -0,0 +1,37 @@
+; RUN: opt -load %projshlibdir/COTPasses.so \
+; RUN:     -analyze -basicaa -ddg           \
+; RUN:     -S -o - %s | FileCheck %s
+; REQUIRES: loadable_module
+
+target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define void @non_local(i32 %c) nounwind uwtable {
+  %a = alloca i32, align 4
+  %b = alloca i32, align 4
+  store i32 0, i32* %a, align 4
+  store i32 0, i32* %b, align 4
+  %cond = icmp ne i32 %c, 0
+  br i1 %cond, label %1, label %2
+
+; <label>:1                                       ; preds = %0
+  store i32 1, i32* %a, align 4
+  br label %3
+
+; <label>:2                                       ; preds = %0
+  store i32 1, i32* %b, align 4
+  br label %3
+
+; <label>:3                                       ; preds = %2, %1
+  store i32 2, i32* %a, align 4
+  ret void
+}
+
+; Only the blocks storing to %a are dependencies of %3: %2 stores to %b.
+;CHECK:      Printing analysis 'Data Dependency Graph Construction' for function 'non_local':
+;CHECK-NEXT: =============================--------------------------------
+;CHECK-NEXT: Data Dependency Graph: 
+;CHECK-NEXT:    %0 { %1:1 %2:1 %3:1 }
+;CHECK-NEXT:    %1 { %3:1 }
+;CHECK-NEXT:    %2 { }
+;CHECK-NEXT:    %3 { }
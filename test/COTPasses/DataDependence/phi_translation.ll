@@ -0,0 +1,44 @@
+; RUN: opt -load %projshlibdir/COTPasses.so \
+; RUN:     -analyze -basicaa -ddg           \
+; RUN:     -S -o - %s | FileCheck %s
+; RUN: opt -load %projshlibdir/COTPasses.so \
+; RUN:     -basicaa -ddg -stats             \
+; RUN:     -disable-output %s 2>&1 | FileCheck --check-prefix=STATS %s
+; REQUIRES: loadable_module
+
+target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define void @phi_translation(i32 %c) nounwind uwtable {
+  %a = alloca i32, align 4
+  %b = alloca i32, align 4
+  store i32 0, i32* %a, align 4
+  %cond = icmp ne i32 %c, 0
+  br i1 %cond, label %1, label %2
+
+; <label>:1                                       ; preds = %0
+  store i32 1, i32* %a, align 4
+  br label %3
+
+; <label>:2                                       ; preds = %0
+  store i32 1, i32* %b, align 4
+  br label %3
+
+; <label>:3                                       ; preds = %2, %1
+  %p = select i1 %cond, i32* %a, i32* %b
+  store i32 2, i32* %p, align 4
+  ret void
+}
+
+; MDA cannot translate the select into the predecessors of %3, so the store
+; of %3 is linked to every block accessing memory.
+;CHECK:      Printing analysis 'Data Dependency Graph Construction' for function 'phi_translation':
+;CHECK-NEXT: =============================--------------------------------
+;CHECK-NEXT: Data Dependency Graph: 
+;CHECK-NEXT:    %0 { %1:1 %2:1 %3:1 }
+;CHECK-NEXT:    %1 { %3:1 }
+;CHECK-NEXT:    %2 { %3:1 }
+;CHECK-NEXT:    %3 { }
+
+;STATS: 1 ddg - Number of MDA results without a dependence
+;STATS: 3 ddg - Number of memory dependences only known to be possible
@@ -0,0 +1,40 @@
+; RUN: opt -load %projshlibdir/COTPasses.so \
+; RUN:     -export-pdg -dg-export-file=- -dg-export-format=json \
+; RUN:     -disable-output %s | FileCheck %s
+; RUN: opt -load %projshlibdir/COTPasses.so \
+; RUN:     -export-pdg -dg-export-file=- -dg-export-format=json \
+; RUN:     -cdg-use-pdf -disable-output %s | FileCheck %s
+; REQUIRES: loadable_module
+
+target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define void @kinds(i32* %p, i1 %c) nounwind uwtable {
+entry:
+  %v = load i32* %p, align 4
+  br i1 %c, label %then, label %else
+
+then:                                             ; preds = %entry
+  store i32 1, i32* %p, align 4
+  br label %exit
+
+else:                                             ; preds = %entry
+  br label %exit
+
+exit:                                             ; preds = %else, %then
+  ret void
+}
+
+; The post-dominance frontier gives the same branch kinds.
+;CHECK:      {"graph":"kinds","nodes":5,"links":5}
+;CHECK-NEXT: {"node":0,"label":"<<EntryNode>>"}
+;CHECK-NEXT: {"node":1,"label":"%entry"}
+;CHECK-NEXT: {"node":2,"label":"%then"}
+;CHECK-NEXT: {"node":3,"label":"%else"}
+;CHECK-NEXT: {"node":4,"label":"%exit"}
+;CHECK-NEXT: {"from":0,"to":1,"type":"control","kinds":["control"]}
+;CHECK-NEXT: {"from":0,"to":4,"type":"control","kinds":["control"]}
+;CHECK-NEXT: {"from":1,"to":2,"type":"data","kinds":["anti","memory"]}
+;CHECK-NEXT: {"from":1,"to":2,"type":"control","kinds":["control","true"]}
+;CHECK-NEXT: {"from":1,"to":3,"type":"control","kinds":["control","false"]}
+;CHECK-NOT:  {
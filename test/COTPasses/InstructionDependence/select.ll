@@ -0,0 +1,32 @@
+; RUN: opt -load %projshlibdir/COTPasses.so \
+; RUN:     -analyze -idg                    \
+; RUN:     -S -o - %s | FileCheck %s
+; REQUIRES: loadable_module
+
+target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @select(i32 %a) nounwind uwtable {
+  %1 = icmp ne i32 %a, 0
+  br i1 %1, label %2, label %4
+
+; <label>:2                                       ; preds = %0
+  %3 = add nsw i32 %a, 1
+  ret i32 %3
+
+; <label>:4                                       ; preds = %0
+  %5 = sub nsw i32 %a, 1
+  ret i32 %5
+}
+
+; Nodes are numbered after the instructions: #1 is %1, #2 the branch.
+;CHECK:      Printing analysis 'Instruction Dependency Graph Construction' for function 'select':
+;CHECK-NEXT: =============================--------------------------------
+;CHECK-NEXT: Instruction Dependency Graph: 
+;CHECK-NEXT:     <<EntryNode>> { #1:0 #2:0 }
+;CHECK-NEXT:     #1 { #2:1 }
+;CHECK-NEXT:     #2 { #3:0 #4:0 #5:0 #6:0 }
+;CHECK-NEXT:     #3 { #4:1 }
+;CHECK-NEXT:     #4 { }
+;CHECK-NEXT:     #5 { #6:1 }
+;CHECK-NEXT:     #6 { }
@@ -0,0 +1,88 @@
+; RUN: opt -load %projshlibdir/COTPasses.so                        \
+; RUN:     -analyze -basicaa -ddg-alias-sets                       \
+; RUN:     -cdg -dg-components -ddg -dg-components                 \
+; RUN:     -S -o - %s | FileCheck %s
+; REQUIRES: loadable_module
+
+target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @loop() nounwind uwtable {
+  %A = alloca [10 x i32], align 16
+  %i = alloca i32, align 4
+  br label %1
+
+; <label>:1                                       ; preds = %9, %0
+  %2 = load i32* %i, align 4
+  %3 = icmp slt i32 %2, 10
+  br i1 %3, label %4, label %12
+
+; <label>:4                                       ; preds = %1
+  %5 = load i32* %i, align 4
+  %6 = load i32* %i, align 4
+  %7 = sext i32 %6 to i64
+  %8 = getelementptr inbounds [10 x i32]* %A, i32 0, i64 %7
+  store i32 %5, i32* %8, align 4
+  br label %9
+
+; <label>:9                                       ; preds = %4
+  %10 = load i32* %i, align 4
+  %11 = add nsw i32 %10, 1
+  store i32 %11, i32* %i, align 4
+  br label %1
+
+; <label>:12                                      ; preds = %1
+  ret i32 0
+}
+
+define void @diamond(i32 %c) nounwind uwtable {
+  %a = alloca i32, align 4
+  %b = alloca i32, align 4
+  store i32 0, i32* %a, align 4
+  %cond = icmp ne i32 %c, 0
+  br i1 %cond, label %1, label %2
+
+; <label>:1                                       ; preds = %0
+  %x = load i32* %a, align 4
+  store i32 %x, i32* %b, align 4
+  br label %3
+
+; <label>:2                                       ; preds = %0
+  %y = load i32* %b, align 4
+  br label %3
+
+; <label>:3                                       ; preds = %2, %1
+  %z = load i32* %a, align 4
+  ret void
+}
+
+; Components are printed once the control layer is built, then again once
+; the data layer thawed and froze the graph: they must be computed again,
+; and again for the next function once the graph is cleared. Alias sets
+; link the accesses to %i both ways, making a cycle of the loop body.
+;CHECK:      Printing analysis 'Dependency Graph Components' for function 'loop':
+;CHECK-NEXT: Components of the dependency graph: 6 components, 3 levels
+;CHECK-NEXT:     0 { %0 } level 1
+;CHECK-NEXT:     1 { %4 } level 2
+;CHECK-NEXT:     2 { %9 } level 2
+;CHECK-NEXT:     3 { %1 } level 1
+;CHECK-NEXT:     4 { %12 } level 1
+;CHECK-NEXT:     5 { <<EntryNode>> } level 0
+;CHECK:      Printing analysis 'Dependency Graph Components' for function 'loop':
+;CHECK-NEXT: Components of the dependency graph: 4 components, 3 levels
+;CHECK-NEXT:     0 { %1 %4 %9 } level 2, cyclic
+;CHECK-NEXT:     1 { %0 } level 1
+;CHECK-NEXT:     2 { %12 } level 1
+;CHECK-NEXT:     3 { <<EntryNode>> } level 0
+
+;CHECK:      Printing analysis 'Dependency Graph Components' for function 'diamond':
+;CHECK-NEXT: Components of the dependency graph: 5 components, 3 levels
+;CHECK-NEXT:     0 { %1 } level 2
+;CHECK-NEXT:     1 { %2 } level 2
+;CHECK-NEXT:     2 { %0 } level 1
+;CHECK-NEXT:     3 { %3 } level 1
+;CHECK-NEXT:     4 { <<EntryNode>> } level 0
+;CHECK:      Printing analysis 'Dependency Graph Components' for function 'diamond':
+;CHECK-NEXT: Components of the dependency graph: 2 components, 2 levels
+;CHECK-NEXT:     0 { %0 %1 %2 %3 } level 1, cyclic
+;CHECK-NEXT:     1 { <<EntryNode>> } level 0
@@ -0,0 +1,62 @@
+; RUN: opt -load %projshlibdir/COTPasses.so                    \
+; RUN:     -break-crit-edges -export-pdg                        \
+; RUN:     -dg-export-file=- -dg-export-format=json             \
+; RUN:     -disable-output %s | FileCheck %s
+; RUN: opt -load %projshlibdir/COTPasses.so                    \
+; RUN:     -pdg -dg-break-crit-edges -export-pdg                \
+; RUN:     -dg-export-file=- -dg-export-format=json             \
+; RUN:     -disable-output %s | FileCheck %s
+; RUN: opt -load %projshlibdir/COTPasses.so                    \
+; RUN:     -break-crit-edges -export-pdg                        \
+; RUN:     -dg-export-file=- -dg-export-format=json             \
+; RUN:     -ddg-memory-link-budget=1                            \
+; RUN:     -disable-output %s > %t.full
+; RUN: opt -load %projshlibdir/COTPasses.so                    \
+; RUN:     -pdg -dg-break-crit-edges -export-pdg                \
+; RUN:     -dg-export-file=- -dg-export-format=json             \
+; RUN:     -ddg-memory-link-budget=1                            \
+; RUN:     -disable-output %s > %t.incremental
+; RUN: diff %t.full %t.incremental
+; RUN: opt -load %projshlibdir/COTPasses.so                    \
+; RUN:     -pdg -dg-break-crit-edges -export-pdg                \
+; RUN:     -dg-export-file=%t -stats                            \
+; RUN:     -disable-output %s 2>&1 | FileCheck --check-prefix=STATS %s
+; REQUIRES: loadable_module
+
+target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @crit(i32* %p, i1 %c) nounwind uwtable {
+entry:
+  %v = load i32* %p, align 4
+  br i1 %c, label %then, label %exit
+
+then:                                             ; preds = %entry
+  store i32 %v, i32* %p, align 4
+  br label %exit
+
+exit:                                             ; preds = %then, %entry
+  %r = phi i32 [ 0, %entry ], [ %v, %then ]
+  ret i32 %r
+}
+
+; The graph updated after the split is the one built after it, also when
+; the data layer is rebuilt under a memory link budget.
+;CHECK:      {"graph":"crit","nodes":5,"links":6}
+;CHECK-NEXT: {"node":0,"label":"<<EntryNode>>"}
+;CHECK-NEXT: {"node":1,"label":"%entry"}
+;CHECK-NEXT: {"node":2,"label":"%entry.exit_crit_edge"}
+;CHECK-NEXT: {"node":3,"label":"%then"}
+;CHECK-NEXT: {"node":4,"label":"%exit"}
+;CHECK-NEXT: {"from":0,"to":1,"type":"control","kinds":["control"]}
+;CHECK-NEXT: {"from":0,"to":4,"type":"control","kinds":["control"]}
+;CHECK-NEXT: {"from":1,"to":2,"type":"control","kinds":["control","false"]}
+;CHECK-NEXT: {"from":1,"to":3,"type":"data","kinds":["flow","anti","memory"]}
+;CHECK-NEXT: {"from":1,"to":3,"type":"control","kinds":["control","true"]}
+;CHECK-NEXT: {"from":1,"to":4,"type":"data","kinds":["flow"]}
+;CHECK-NOT:  {
+
+; The program dependency graph is built once, before the split.
+;STATS:     1 dg-break-crit-edges - Number of critical edges split
+;STATS:     1 dg-update - Number of incremental dependency graph updates
+;STATS:     4 pdg - Number of nodes of program dependency graphs
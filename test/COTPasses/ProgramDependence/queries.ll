@@ -0,0 +1,101 @@
+; RUN: opt -load %projshlibdir/COTPasses.so                     \
+; RUN:     -analyze -basicaa -ddg-alias-sets -pdg -dg-queries  \
+; RUN:     -S -o - %s | FileCheck %s
+; RUN: opt -load %projshlibdir/COTPasses.so                     \
+; RUN:     -analyze -basicaa -ddg-alias-sets -pdg -dg-queries  \
+; RUN:     -dg-queries-search=linear                            \
+; RUN:     -S -o - %s | FileCheck %s
+; RUN: opt -load %projshlibdir/COTPasses.so                     \
+; RUN:     -analyze -basicaa -ddg-alias-sets -pdg -dg-queries  \
+; RUN:     -dg-queries-search=bitset                            \
+; RUN:     -S -o - %s | FileCheck %s
+; RUN: opt -load %projshlibdir/COTPasses.so                     \
+; RUN:     -analyze -basicaa -ddg-alias-sets -pdg -dg-queries  \
+; RUN:     -dg-queries-memo=36                                  \
+; RUN:     -S -o - %s | FileCheck --check-prefix=ALL %s
+; RUN: opt -load %projshlibdir/COTPasses.so                     \
+; RUN:     -analyze -basicaa -ddg-alias-sets -pdg -dg-queries  \
+; RUN:     -dg-queries-memo=0                                   \
+; RUN:     -S -o - %s | FileCheck --check-prefix=NONE %s
+; RUN: opt -load %projshlibdir/COTPasses.so                     \
+; RUN:     -analyze -cdg -dg-queries                            \
+; RUN:     -S -o - %s | FileCheck --check-prefix=CDG %s
+; REQUIRES: loadable_module
+
+target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @queries() nounwind uwtable {
+  %A = alloca [10 x i32], align 16
+  %i = alloca i32, align 4
+  br label %1
+
+; <label>:1                                       ; preds = %9, %0
+  %2 = load i32* %i, align 4
+  %3 = icmp slt i32 %2, 10
+  br i1 %3, label %4, label %12
+
+; <label>:4                                       ; preds = %1
+  %5 = load i32* %i, align 4
+  %6 = load i32* %i, align 4
+  %7 = sext i32 %6 to i64
+  %8 = getelementptr inbounds [10 x i32]* %A, i32 0, i64 %7
+  store i32 %5, i32* %8, align 4
+  br label %9
+
+; <label>:9                                       ; preds = %4
+  %10 = load i32* %i, align 4
+  %11 = add nsw i32 %10, 1
+  store i32 %11, i32* %i, align 4
+  br label %1
+
+; <label>:12                                      ; preds = %1
+  ret i32 0
+}
+
+; Batches, one-to-many queries and point queries find the same links, with
+; each policy searching them.
+;CHECK:      Printing analysis 'Dependency Graph Queries' for function 'queries':
+;CHECK-NEXT: Queries with {{sorted|linear|bitset}} link search:
+;CHECK-NEXT: Batch answers:
+;CHECK-NEXT:     <<EntryNode>> { %0 %1 %12 }
+;CHECK-NEXT:     %0 { %1 %4 %9 }
+;CHECK-NEXT:     %1 { %4 %9 }
+;CHECK-NEXT:     %4 { %9 }
+;CHECK-NEXT:     %9 { %1 %4 }
+;CHECK-NEXT:     %12 { }
+;CHECK-NEXT: One-to-many answers:
+;CHECK-NEXT:     <<EntryNode>> { %0 %1 %12 }
+;CHECK-NEXT:     %0 { %1 %4 %9 }
+;CHECK-NEXT:     %1 { %4 %9 }
+;CHECK-NEXT:     %4 { %9 }
+;CHECK-NEXT:     %9 { %1 %4 }
+;CHECK-NEXT:     %12 { }
+;CHECK-NEXT: Point answers:
+;CHECK-NEXT:     <<EntryNode>> { %0 %1 %12 }
+;CHECK-NEXT:     %0 { %1 %4 %9 }
+;CHECK-NEXT:     %1 { %4 %9 }
+;CHECK-NEXT:     %4 { %9 }
+;CHECK-NEXT:     %9 { %1 %4 }
+;CHECK-NEXT:     %12 { }
+;CHECK-NEXT: Memo of 4 answers: 40 hits, 37 misses
+
+; The 36 pairs are asked twice each, the second time hitting. The last 4
+; are still in the memo, while the first one was evicted, unless the memo
+; holds every pair.
+;ALL:        Queries with sorted link search:
+;ALL:        Memo of 36 answers: 73 hits, 36 misses
+
+; Without a memo, point queries are not counted.
+;NONE:       Memo of 0 answers: 0 hits, 0 misses
+
+; The control layer alone has a few links per node: they are scanned.
+;CDG:      Printing analysis 'Dependency Graph Queries' for function 'queries':
+;CDG-NEXT: Queries with linear link search:
+;CDG-NEXT: Batch answers:
+;CDG-NEXT:     <<EntryNode>> { %0 %1 %12 }
+;CDG-NEXT:     %0 { }
+;CDG-NEXT:     %1 { %4 %9 }
+;CDG-NEXT:     %4 { }
+;CDG-NEXT:     %9 { }
+;CDG-NEXT:     %12 { }
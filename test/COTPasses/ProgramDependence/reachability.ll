@@ -0,0 +1,59 @@
+; RUN: opt -load %projshlibdir/COTPasses.so                     \
+; RUN:     -analyze -basicaa -ddg-alias-sets -pdg -dg-reaches  \
+; RUN:     -S -o - %s | FileCheck --check-prefix=MATRIX %s
+; RUN: opt -load %projshlibdir/COTPasses.so                     \
+; RUN:     -analyze -basicaa -ddg-alias-sets -pdg -dg-reaches  \
+; RUN:     -dg-reaches-max-matrix=0                             \
+; RUN:     -S -o - %s | FileCheck --check-prefix=LABELS %s
+; REQUIRES: loadable_module
+
+target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @reaches() nounwind uwtable {
+  %A = alloca [10 x i32], align 16
+  %i = alloca i32, align 4
+  br label %1
+
+; <label>:1                                       ; preds = %9, %0
+  %2 = load i32* %i, align 4
+  %3 = icmp slt i32 %2, 10
+  br i1 %3, label %4, label %12
+
+; <label>:4                                       ; preds = %1
+  %5 = load i32* %i, align 4
+  %6 = load i32* %i, align 4
+  %7 = sext i32 %6 to i64
+  %8 = getelementptr inbounds [10 x i32]* %A, i32 0, i64 %7
+  store i32 %5, i32* %8, align 4
+  br label %9
+
+; <label>:9                                       ; preds = %4
+  %10 = load i32* %i, align 4
+  %11 = add nsw i32 %10, 1
+  store i32 %11, i32* %i, align 4
+  br label %1
+
+; <label>:12                                      ; preds = %1
+  ret i32 0
+}
+
+; The store to %i in %9 and the loads of %i in %1 and %4 share an alias set,
+; which links them both ways: %1, %4 and %9 reach each other.
+;MATRIX:      Printing analysis 'Dependency Graph Reachability' for function 'reaches':
+;MATRIX-NEXT: Reachability of the dependency graph (bit matrix):
+;MATRIX-NEXT:     <<EntryNode>> { <<EntryNode>> %0 %1 %4 %9 %12 }
+;MATRIX-NEXT:     %0 { %0 %1 %4 %9 }
+;MATRIX-NEXT:     %1 { %1 %4 %9 }
+;MATRIX-NEXT:     %4 { %1 %4 %9 }
+;MATRIX-NEXT:     %9 { %1 %4 %9 }
+;MATRIX-NEXT:     %12 { %12 }
+
+;LABELS:      Printing analysis 'Dependency Graph Reachability' for function 'reaches':
+;LABELS-NEXT: Reachability of the dependency graph (interval labels):
+;LABELS-NEXT:     <<EntryNode>> { <<EntryNode>> %0 %1 %4 %9 %12 }
+;LABELS-NEXT:     %0 { %0 %1 %4 %9 }
+;LABELS-NEXT:     %1 { %1 %4 %9 }
+;LABELS-NEXT:     %4 { %1 %4 %9 }
+;LABELS-NEXT:     %9 { %1 %4 %9 }
+;LABELS-NEXT:     %12 { %12 }
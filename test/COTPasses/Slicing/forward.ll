@@ -0,0 +1,31 @@
+; RUN: opt -load %projshlibdir/COTPasses.so \
+; RUN:     -analyze -pdg-slice -pdg-slice-criterion=%1 \
+; RUN:     -pdg-slice-direction=forward \
+; RUN:     -S -o - %s | FileCheck %s
+; REQUIRES: loadable_module
+
+target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @select(i32 %a) nounwind uwtable {
+  %1 = icmp ne i32 %a, 0
+  br i1 %1, label %2, label %4
+
+; <label>:2                                       ; preds = %0
+  %3 = add nsw i32 %a, 1
+  ret i32 %3
+
+; <label>:4                                       ; preds = %0
+  %5 = sub nsw i32 %a, 1
+  ret i32 %5
+}
+
+; The comparison controls both branches, but not the argument it reads.
+;CHECK:      Printing analysis 'Program Dependency Graph Slicing' for function 'select':
+;CHECK-NEXT: Forward slice of %1:
+;CHECK-NEXT:     %1 = icmp ne i32 %a, 0
+;CHECK-NEXT:     br i1 %1, label %2, label %4
+;CHECK-NEXT:     %3 = add nsw i32 %a, 1
+;CHECK-NEXT:     ret i32 %3
+;CHECK-NEXT:     %5 = sub nsw i32 %a, 1
+;CHECK-NEXT:     ret i32 %5
@@ -0,0 +1,68 @@
+; RUN: opt -load %projshlibdir/COTPasses.so                         \
+; RUN:     -analyze -pdg-slice -pdg-slice-criterion=%4 -pdg-slice-lazy \
+; RUN:     -S -o - %s | FileCheck %s
+; RUN: opt -load %projshlibdir/COTPasses.so                         \
+; RUN:     -pdg-slice -pdg-slice-criterion=%4 -pdg-slice-lazy -stats   \
+; RUN:     -disable-output %s 2>&1 | FileCheck --check-prefix=STATS %s
+; RUN: opt -load %projshlibdir/COTPasses.so                         \
+; RUN:     -analyze -pdg-slice -pdg-slice-criterion=%5                 \
+; RUN:     -S -o - %s > %t.eager
+; RUN: opt -load %projshlibdir/COTPasses.so                         \
+; RUN:     -analyze -pdg-slice -pdg-slice-criterion=%5 -pdg-slice-lazy \
+; RUN:     -S -o - %s > %t.lazy
+; RUN: diff %t.eager %t.lazy
+; RUN: FileCheck --check-prefix=INST %s < %t.lazy
+; RUN: opt -load %projshlibdir/COTPasses.so                         \
+; RUN:     -pdg-slice -pdg-slice-criterion=%5 -pdg-slice-lazy -stats   \
+; RUN:     -disable-output %s 2>&1 | FileCheck --check-prefix=INSTSTATS %s
+; REQUIRES: loadable_module
+
+target datalayout = "e-p:64:64:64-i1:8:8-i8:8:8-i16:16:16-i32:32:32-i64:64:64-f32:32:32-f64:64:64-v64:64:64-v128:128:128-a0:0:64-s0:64:64-f80:128:128-n8:16:32:64-S128"
+target triple = "x86_64-unknown-linux-gnu"
+
+define i32 @lazy() nounwind uwtable {
+  %A = alloca [10 x i32], align 16
+  %i = alloca i32, align 4
+  br label %1
+
+; <label>:1                                       ; preds = %9, %0
+  %2 = load i32* %i, align 4
+  %3 = icmp slt i32 %2, 10
+  br i1 %3, label %4, label %12
+
+; <label>:4                                       ; preds = %1
+  %5 = load i32* %i, align 4
+  %6 = load i32* %i, align 4
+  %7 = sext i32 %6 to i64
+  %8 = getelementptr inbounds [10 x i32]* %A, i32 0, i64 %7
+  store i32 %5, i32* %8, align 4
+  br label %9
+
+; <label>:9                                       ; preds = %4
+  %10 = load i32* %i, align 4
+  %11 = add nsw i32 %10, 1
+  store i32 %11, i32* %i, align 4
+  br label %1
+
+; <label>:12                                      ; preds = %1
+  ret i32 0
+}
+
+;CHECK:      Printing analysis 'Program Dependency Graph Slicing' for function 'lazy':
+;CHECK-NEXT: Backward slice of %4:
+;CHECK-NEXT:     %0
+;CHECK-NEXT:     %1
+;CHECK-NEXT:     %4
+
+; Only the blocks of the slice had their dependences computed.
+;STATS-NOT: cdg -
+;STATS: 3 lazy-pdg - Number of blocks whose dependences were computed on demand
+;STATS-NOT: pdg - Number of nodes of program dependency graphs
+
+; Instructions are sliced as on the eager graph, with the control links of
+; the lazy one.
+;INST:      Backward slice of %5:
+;INST:        %5 = load i32* %i, align 4
+
+;INSTSTATS-NOT: cdg -
+;INSTSTATS:     ddg - Number of MDA queries for stores
@@ -29,8 +29,15 @@ public:
     CreateControlDependencyGraphPass();
     CreateDataDependencyGraphPass();
     CreateProgramDependencyGraphPass();
+    CreateDependencyLayersPass();
+    CreatePostDominanceFrontierPass();
+    CreateParallelDependencyGraphsPass();
+    CreateInstructionDependencyGraphPass();
+    CreateProgramSlicingPass();
+    CreateLazyProgramDependencyGraphPass();
 
     // Transformations.
+    CreateCriticalEdgeSplittingPass();
   }
 };
 
@@ -48,6 +55,12 @@ public:
     initializeDataDependencyGraphPass(Registry);
     initializeControlDependencyGraphPass(Registry);
     initializeProgramDependencyGraphPass(Registry);
+    initializeDependencyLayersPass(Registry);
+    initializePostDominanceFrontierPass(Registry);
+    initializeParallelDependencyGraphsPass(Registry);
+    initializeInstructionDependencyGraphPass(Registry);
+    initializeProgramSlicingPass(Registry);
+    initializeLazyProgramDependencyGraphPass(Registry);
 
     // Dot Viewer Passes
     initializeDataDependencyViewerPass(Registry);
@@ -59,7 +72,18 @@ public:
     initializeControlDependencyPrinterPass(Registry);
     initializeProgramDependencyPrinterPass(Registry);
 
+    // Streaming Exporter Passes
+    initializeDataDependencyExporterPass(Registry);
+    initializeControlDependencyExporterPass(Registry);
+    initializeProgramDependencyExporterPass(Registry);
+
+    // Query Printer Passes
+    initializeReachabilityPrinterPass(Registry);
+    initializeComponentsPrinterPass(Registry);
+    initializeQueriesPrinterPass(Registry);
+
     // Transformations.
+    initializeCriticalEdgeSplittingPass(Registry);
   }
 };
 
@@ -0,0 +1,335 @@
+/** ---*- C++ -*--- IRGenerator.cpp
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "IRGenerator.h"
+
+#include "llvm/DerivedTypes.h"
+#include "llvm/Function.h"
+#include "llvm/Instructions.h"
+#include "llvm/LLVMContext.h"
+#include "llvm/Module.h"
+#include "llvm/ADT/Twine.h"
+#include "llvm/Support/IRBuilder.h"
+
+#include <vector>
+
+
+using namespace cot;
+using namespace llvm;
+
+
+static const unsigned ArraySize = 64;
+
+static const char *const ShapeNames[NumIRShapes] = {
+  "loops", "switch", "memory", "functions", "irreducible"
+};
+
+
+const char *cot::getShapeName(IRShape Shape)
+{
+  return ShapeNames[Shape];
+}
+
+
+/// Address of Array[Index & (ArraySize - 1)].
+static Value *createElementPtr(IRBuilder<> &B, Value *Array, Value *Index)
+{
+  Value *Idx[] = {
+    B.getInt32(0), B.CreateAnd(Index, B.getInt32(ArraySize - 1))
+  };
+  return B.CreateInBoundsGEP(Array, Idx);
+}
+
+
+/// Allocate the two arrays the code of F works on.
+static void createArrays(IRBuilder<> &B, Value *&A, Value *&C)
+{
+  Type *ArrayTy = ArrayType::get(B.getInt32Ty(), ArraySize);
+  A = B.CreateAlloca(ArrayTy, 0, "a");
+  C = B.CreateAlloca(ArrayTy, 0, "b");
+}
+
+
+/// Return the first element of Array.
+static void createReturn(IRBuilder<> &B, Value *Array)
+{
+  B.CreateRet(B.CreateLoad(B.CreateConstInBoundsGEP2_32(Array, 0, 0)));
+}
+
+
+Module *IRGenerator::generate(IRShape Shape, unsigned Size)
+{
+  Module *M = new Module(getShapeName(Shape), mCtx);
+  switch (Shape)
+  {
+  case LoopNestShape:
+    generateLoopNests(*M, Size);
+    break;
+  case SwitchShape:
+    generateSwitch(*M, Size);
+    break;
+  case MemoryShape:
+    generateMemory(*M, Size);
+    break;
+  case FunctionsShape:
+    generateFunctions(*M, Size);
+    break;
+  case IrreducibleShape:
+    generateIrreducible(*M, Size);
+    break;
+  }
+  return M;
+}
+
+
+/// Xorshift generator: the same stream on every host.
+uint32_t IRGenerator::random(uint32_t Bound)
+{
+  mState ^= mState << 13;
+  mState ^= mState >> 17;
+  mState ^= mState << 5;
+  return mState % Bound;
+}
+
+
+/// A function of type i32 (i32 %n) named Name.
+Function *IRGenerator::createFunction(Module &M, const Twine &Name)
+{
+  Type *I32 = Type::getInt32Ty(mCtx);
+  FunctionType *FTy = FunctionType::get(I32, I32, false);
+  Function *F = Function::Create(FTy, GlobalValue::ExternalLinkage, Name, &M);
+  F->arg_begin()->setName("n");
+  return F;
+}
+
+
+/*!
+ * Emit a nest of Depth loops counting up to %n, entered from BB, which must
+ * have no terminator. The innermost body updates Array. Return the exit
+ * block of the outermost loop, left without terminator.
+ */
+BasicBlock *IRGenerator::emitLoopNest(Function &F, BasicBlock *BB,
+                                      Value *Array, unsigned Depth)
+{
+  BasicBlock *Header = BasicBlock::Create(mCtx, "", &F);
+  BasicBlock *Body = BasicBlock::Create(mCtx, "", &F);
+  BasicBlock *Exit = BasicBlock::Create(mCtx, "", &F);
+
+  IRBuilder<> B(BB);
+  B.CreateBr(Header);
+
+  B.SetInsertPoint(Header);
+  PHINode *I = B.CreatePHI(B.getInt32Ty(), 2);
+  I->addIncoming(B.getInt32(0), BB);
+  B.CreateCondBr(B.CreateICmpSLT(I, F.arg_begin()), Body, Exit);
+
+  BasicBlock *Latch = Body;
+  if (Depth > 1)
+    Latch = emitLoopNest(F, Body, Array, Depth - 1);
+  else
+  {
+    B.SetInsertPoint(Body);
+    Value *X = B.CreateLoad(createElementPtr(B, Array, I));
+    B.CreateStore(B.CreateAdd(X, I),
+                  createElementPtr(B, Array, B.CreateAdd(I, B.getInt32(1))));
+  }
+
+  B.SetInsertPoint(Latch);
+  Value *Next = B.CreateAdd(I, B.getInt32(1));
+  I->addIncoming(Next, Latch);
+  B.CreateBr(Header);
+  return Exit;
+}
+
+
+/*!
+ * Append NumOps loads and stores of random elements of A and C to BB. Values
+ * loaded are stored back; one access in four has an index only known at run
+ * time.
+ */
+void IRGenerator::emitMemoryOps(BasicBlock *BB, Value *A, Value *C,
+                                unsigned NumOps)
+{
+  IRBuilder<> B(BB);
+  Value *Last = BB->getParent()->arg_begin();
+  for (unsigned Op = 0; Op != NumOps; ++Op)
+  {
+    Value *Array = random(2) ? A : C;
+    Value *Index = random(4) ? B.getInt32(random(ArraySize)) : Last;
+    Value *Ptr = createElementPtr(B, Array, Index);
+    if (random(2))
+      Last = B.CreateLoad(Ptr);
+    else
+      B.CreateStore(Last, Ptr);
+  }
+}
+
+
+/// Size nests of loops, one after the other.
+void IRGenerator::generateLoopNests(Module &M, unsigned Size)
+{
+  Function *F = createFunction(M, "loops");
+  BasicBlock *BB = BasicBlock::Create(mCtx, "entry", F);
+  IRBuilder<> B(BB);
+  Value *A, *C;
+  createArrays(B, A, C);
+
+  for (unsigned Nest = 0; Nest != Size; ++Nest)
+    BB = emitLoopNest(*F, BB, A, mLoopDepth);
+
+  B.SetInsertPoint(BB);
+  createReturn(B, A);
+}
+
+
+/// A switch on %n with Size cases, a quarter of them falling through.
+void IRGenerator::generateSwitch(Module &M, unsigned Size)
+{
+  Function *F = createFunction(M, "switch");
+  BasicBlock *Entry = BasicBlock::Create(mCtx, "entry", F);
+  IRBuilder<> B(Entry);
+  Value *A, *C;
+  createArrays(B, A, C);
+
+  BasicBlock *Default = BasicBlock::Create(mCtx, "", F);
+  std::vector<BasicBlock *> Cases;
+  for (unsigned K = 0; K != Size; ++K)
+    Cases.push_back(BasicBlock::Create(mCtx, "", F));
+  BasicBlock *Merge = BasicBlock::Create(mCtx, "", F);
+
+  SwitchInst *SI = B.CreateSwitch(F->arg_begin(), Default, Size);
+  for (unsigned K = 0; K != Size; ++K)
+  {
+    SI->addCase(B.getInt32(K), Cases[K]);
+    emitMemoryOps(Cases[K], A, C, 2);
+    B.SetInsertPoint(Cases[K]);
+    if (K + 1 != Size && !random(4))
+      B.CreateBr(Cases[K + 1]);
+    else
+      B.CreateBr(Merge);
+  }
+
+  emitMemoryOps(Default, A, C, 1);
+  B.SetInsertPoint(Default);
+  B.CreateBr(Merge);
+
+  B.SetInsertPoint(Merge);
+  createReturn(B, A);
+}
+
+
+/// A chain of Size blocks holding 16 memory accesses each.
+void IRGenerator::generateMemory(Module &M, unsigned Size)
+{
+  Function *F = createFunction(M, "memory");
+  BasicBlock *BB = BasicBlock::Create(mCtx, "entry", F);
+  IRBuilder<> B(BB);
+  Value *A, *C;
+  createArrays(B, A, C);
+
+  for (unsigned K = 0; K != Size; ++K)
+  {
+    BasicBlock *Next = BasicBlock::Create(mCtx, "", F);
+    B.SetInsertPoint(BB);
+    B.CreateBr(Next);
+    emitMemoryOps(Next, A, C, 16);
+    BB = Next;
+  }
+
+  B.SetInsertPoint(BB);
+  createReturn(B, A);
+}
+
+
+/// Size functions holding a diamond each, and a function calling them all.
+void IRGenerator::generateFunctions(Module &M, unsigned Size)
+{
+  std::vector<Function *> Callees;
+  for (unsigned K = 0; K != Size; ++K)
+  {
+    Function *F = createFunction(M, "f" + Twine(K));
+    Callees.push_back(F);
+
+    BasicBlock *Entry = BasicBlock::Create(mCtx, "entry", F);
+    BasicBlock *Then = BasicBlock::Create(mCtx, "", F);
+    BasicBlock *Else = BasicBlock::Create(mCtx, "", F);
+    BasicBlock *Merge = BasicBlock::Create(mCtx, "", F);
+
+    IRBuilder<> B(Entry);
+    Value *A, *C;
+    createArrays(B, A, C);
+    B.CreateCondBr(B.CreateICmpSLT(F->arg_begin(), B.getInt32(K)), Then,
+                   Else);
+    emitMemoryOps(Then, A, C, 2);
+    emitMemoryOps(Else, A, C, 2);
+    B.SetInsertPoint(Then);
+    B.CreateBr(Merge);
+    B.SetInsertPoint(Else);
+    B.CreateBr(Merge);
+    B.SetInsertPoint(Merge);
+    createReturn(B, A);
+  }
+
+  Function *F = createFunction(M, "caller");
+  IRBuilder<> B(BasicBlock::Create(mCtx, "entry", F));
+  Value *Sum = F->arg_begin();
+  for (std::vector<Function *>::const_iterator I = Callees.begin(),
+         E = Callees.end(); I != E; ++I)
+    Sum = B.CreateAdd(Sum, B.CreateCall(*I, Sum));
+  B.CreateRet(Sum);
+}
+
+
+/*!
+ * Size loops with two entries, one after the other: each is entered from
+ * the previous exit either at its first or at its second block.
+ */
+void IRGenerator::generateIrreducible(Module &M, unsigned Size)
+{
+  Function *F = createFunction(M, "irreducible");
+  BasicBlock *BB = BasicBlock::Create(mCtx, "entry", F);
+  IRBuilder<> B(BB);
+  Value *A, *C;
+  createArrays(B, A, C);
+
+  for (unsigned K = 0; K != Size; ++K)
+  {
+    BasicBlock *First = BasicBlock::Create(mCtx, "", F);
+    BasicBlock *Second = BasicBlock::Create(mCtx, "", F);
+    BasicBlock *Exit = BasicBlock::Create(mCtx, "", F);
+
+    B.SetInsertPoint(BB);
+    B.CreateCondBr(B.CreateICmpSLT(F->arg_begin(), B.getInt32(K)), First,
+                   Second);
+
+    emitMemoryOps(First, A, C, 2);
+    B.SetInsertPoint(First);
+    Value *X = B.CreateLoad(B.CreateConstInBoundsGEP2_32(A, 0, K % ArraySize));
+    B.CreateCondBr(B.CreateICmpSGT(X, B.getInt32(0)), Second, Exit);
+
+    emitMemoryOps(Second, A, C, 2);
+    B.SetInsertPoint(Second);
+    Value *Y = B.CreateLoad(B.CreateConstInBoundsGEP2_32(C, 0, K % ArraySize));
+    B.CreateCondBr(B.CreateICmpSGT(Y, B.getInt32(0)), First, Exit);
+
+    BB = Exit;
+  }
+
+  B.SetInsertPoint(BB);
+  createReturn(B, A);
+}
@@ -0,0 +1,90 @@
+/** ---*- C++ -*--- IRGenerator.h
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#ifndef COT_BENCH_IRGENERATOR_H
+#define COT_BENCH_IRGENERATOR_H
+
+#include "llvm/Support/DataTypes.h"
+
+namespace llvm
+{
+  class BasicBlock;
+  class Function;
+  class LLVMContext;
+  class Module;
+  class Twine;
+  class Value;
+}
+
+namespace cot
+{
+  /// Kinds of synthetic functions, each stressing a part of the analyses.
+  enum IRShape
+  {
+    LoopNestShape,     ///< Deeply nested counted loops.
+    SwitchShape,       ///< One wide switch with fall-through cases.
+    MemoryShape,       ///< Long chains of loads and stores to two arrays.
+    FunctionsShape,    ///< Many small functions and a caller of them all.
+    IrreducibleShape   ///< Chained two-entry loops.
+  };
+
+  static const unsigned NumIRShapes = IrreducibleShape + 1;
+
+  /// Name of a shape, as accepted on the command line.
+  const char *getShapeName(IRShape Shape);
+
+  /*!
+   * Generator of synthetic, verifiable IR. Size scales the number of blocks
+   * linearly for every shape; the output only depends on the shape, the size
+   * and the seed, so runs on different commits analyse the same code.
+   */
+  class IRGenerator
+  {
+  public:
+    IRGenerator(llvm::LLVMContext &Ctx, uint32_t Seed = 1) :
+    mCtx(Ctx), mState(Seed ? Seed : 1), mLoopDepth(6) { }
+
+    /// Depth of the loop nests of LoopNestShape.
+    void setLoopDepth(unsigned Depth) { mLoopDepth = Depth ? Depth : 1; }
+
+    /// A new module holding code of the given shape; the caller owns it.
+    llvm::Module *generate(IRShape Shape, unsigned Size);
+
+  private:
+    uint32_t random(uint32_t Bound);
+
+    llvm::Function *createFunction(llvm::Module &M, const llvm::Twine &Name);
+
+    llvm::BasicBlock *emitLoopNest(llvm::Function &F, llvm::BasicBlock *BB,
+                                   llvm::Value *Array, unsigned Depth);
+    void emitMemoryOps(llvm::BasicBlock *BB, llvm::Value *A, llvm::Value *B,
+                       unsigned NumOps);
+
+    void generateLoopNests(llvm::Module &M, unsigned Size);
+    void generateSwitch(llvm::Module &M, unsigned Size);
+    void generateMemory(llvm::Module &M, unsigned Size);
+    void generateFunctions(llvm::Module &M, unsigned Size);
+    void generateIrreducible(llvm::Module &M, unsigned Size);
+
+    llvm::LLVMContext &mCtx;
+    uint32_t mState;
+    unsigned mLoopDepth;
+  };
+}
+
+#endif // COT_BENCH_IRGENERATOR_H
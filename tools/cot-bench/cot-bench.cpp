@@ -0,0 +1,416 @@
+/** ---*- C++ -*--- cot-bench.cpp
+ *
+ * Copyright (C) 2012 Marco Minutoli <mminutoli@gmail.com>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see http://www.gnu.org/licenses/.
+ */
+
+#include "IRGenerator.h"
+
+#include "cot/AllPasses.h"
+#include "cot/DependencyGraph/ControlDependencies.h"
+#include "cot/DependencyGraph/DataDependencies.h"
+#include "cot/DependencyGraph/GraphExport.h"
+#include "cot/DependencyGraph/ProgramDependencies.h"
+#include "llvm/Function.h"
+#include "llvm/InitializePasses.h"
+#include "llvm/LLVMContext.h"
+#include "llvm/Module.h"
+#include "llvm/PassManager.h"
+#include "llvm/Analysis/Passes.h"
+#include "llvm/Analysis/Verifier.h"
+#include "llvm/ADT/OwningPtr.h"
+#include "llvm/Config/config.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/PrettyStackTrace.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/Timer.h"
+#include "llvm/Support/raw_ostream.h"
+
+#ifdef HAVE_SYS_RESOURCE_H
+#include <sys/resource.h>
+#endif
+#if defined(LLVM_ON_UNIX) && defined(HAVE_SYS_WAIT_H)
+#include <sys/wait.h>
+#include <unistd.h>
+#define COT_BENCH_FORK 1
+#endif
+
+#include <algorithm>
+
+
+using namespace cot;
+using namespace llvm;
+
+
+namespace {
+
+enum BenchPass
+{
+  CDGPass,
+  DDGPass,
+  PDGPass
+};
+
+const unsigned NumBenchPasses = PDGPass + 1;
+
+const char *const PassNames[NumBenchPasses] = { "cdg", "ddg", "pdg" };
+
+/// Size of a generated module.
+struct ModuleStats
+{
+  ModuleStats() : Functions(0), Blocks(0), Instructions(0) { }
+
+  unsigned Functions;
+  unsigned Blocks;
+  unsigned Instructions;
+};
+
+/// Measures of a benchmark, over every iteration.
+struct BenchResult
+{
+  BenchResult() : Edges(0), BestTime(0), TotalTime(0), MemUsed(0) { }
+
+  uint64_t Edges;
+  double BestTime;
+  double TotalTime;
+  /// Largest net change of the bytes allocated by malloc over a run.
+  ssize_t MemUsed;
+};
+
+} // End anonymous namespace.
+
+
+static cl::list<IRShape>
+Shapes("shape",
+       cl::desc("Shapes of generated code (default: all)"),
+       cl::values(clEnumValN(LoopNestShape, "loops", "Deep loop nests"),
+                  clEnumValN(SwitchShape, "switch", "A wide switch"),
+                  clEnumValN(MemoryShape, "memory",
+                             "Straight-line memory code"),
+                  clEnumValN(FunctionsShape, "functions",
+                             "Many small functions"),
+                  clEnumValN(IrreducibleShape, "irreducible",
+                             "Irreducible loops"),
+                  clEnumValEnd),
+       cl::CommaSeparated);
+
+static cl::list<unsigned>
+Sizes("size",
+      cl::desc("Scales of generated code (default: 256)"),
+      cl::CommaSeparated);
+
+static cl::list<BenchPass>
+Passes("passes",
+       cl::desc("Analyses to time (default: all)"),
+       cl::values(clEnumValN(CDGPass, "cdg", "Control dependency graph"),
+                  clEnumValN(DDGPass, "ddg", "Data dependency graph"),
+                  clEnumValN(PDGPass, "pdg",
+                             "Program dependency graph, including the "
+                             "graphs it requires"),
+                  clEnumValEnd),
+       cl::CommaSeparated);
+
+static cl::opt<unsigned>
+LoopDepth("loop-depth",
+          cl::desc("Depth of generated loop nests"),
+          cl::init(6));
+
+static cl::opt<unsigned>
+Seed("seed",
+     cl::desc("Seed of the generator"),
+     cl::init(1));
+
+static cl::opt<unsigned>
+Iterations("iterations",
+           cl::desc("Runs of each analysis, the best one is reported"),
+           cl::init(3));
+
+static cl::opt<std::string>
+Label("label",
+      cl::desc("Tag of every record, e.g. the commit being measured"),
+      cl::init(""));
+
+static cl::opt<bool>
+EmitIR("emit-ir",
+       cl::desc("Print the generated modules instead of timing analyses"),
+       cl::init(false));
+
+static cl::opt<std::string>
+OutputFilename("o",
+               cl::desc("Output file"),
+               cl::value_desc("filename"),
+               cl::init("-"));
+
+
+static ModuleStats countModule(const Module &M)
+{
+  ModuleStats Stats;
+  for (Module::const_iterator F = M.begin(), FE = M.end(); F != FE; ++F)
+  {
+    if (F->isDeclaration())
+      continue;
+    ++Stats.Functions;
+    for (Function::const_iterator BB = F->begin(), BE = F->end(); BB != BE;
+         ++BB)
+    {
+      ++Stats.Blocks;
+      Stats.Instructions += BB->size();
+    }
+  }
+  return Stats;
+}
+
+
+static Pass *createBenchPass(BenchPass Kind)
+{
+  switch (Kind)
+  {
+  case CDGPass:
+    return new ControlDependencyGraph();
+  case DDGPass:
+    return new DataDependencyGraph();
+  case PDGPass:
+    return new ProgramDependencyGraph();
+  }
+  return 0;
+}
+
+
+static const DepGraphView &getBenchGraph(Pass *P, BenchPass Kind)
+{
+  switch (Kind)
+  {
+  case CDGPass:
+    return static_cast<ControlDependencyGraph *>(P)->CDG;
+  case DDGPass:
+    return static_cast<DataDependencyGraph *>(P)->DDG;
+  case PDGPass:
+    break;
+  }
+  return static_cast<ProgramDependencyGraph *>(P)->PDG;
+}
+
+
+/*!
+ * Peak resident set size of the process, in bytes; 0 if unknown. Each
+ * benchmark runs in a process of its own where possible, so this is the
+ * peak of that benchmark, on top of what the tool itself uses.
+ */
+static uint64_t getPeakMemory()
+{
+#if defined(HAVE_GETRUSAGE) && defined(HAVE_SYS_RESOURCE_H)
+  struct rusage Usage;
+  if (getrusage(RUSAGE_SELF, &Usage))
+    return 0;
+#ifdef __APPLE__
+  return Usage.ru_maxrss;
+#else
+  return uint64_t(Usage.ru_maxrss) * 1024;
+#endif
+#else
+  return 0;
+#endif
+}
+
+
+/*!
+ * Run the analysis Kind on every function of M, Iterations times, each time
+ * with a new pass manager. Only the runs of the analysis are timed.
+ */
+static BenchResult runBenchmark(Module &M, BenchPass Kind)
+{
+  BenchResult Result;
+  for (unsigned It = 0; It != Iterations; ++It)
+  {
+    FunctionPassManager FPM(&M);
+    FPM.add(createBasicAliasAnalysisPass());
+    Pass *P = createBenchPass(Kind);
+    FPM.add(P);
+    FPM.doInitialization();
+
+    uint64_t Edges = 0;
+    TimeRecord Start = TimeRecord::getCurrentTime(true);
+    for (Module::iterator F = M.begin(), FE = M.end(); F != FE; ++F)
+      if (!F->isDeclaration())
+      {
+        FPM.run(*F);
+        Edges += getBenchGraph(P, Kind).getNumEdges();
+      }
+    TimeRecord Time = TimeRecord::getCurrentTime(false);
+    FPM.doFinalization();
+    Time -= Start;
+
+    double Wall = Time.getWallTime();
+    Result.Edges = Edges;
+    Result.TotalTime += Wall;
+    if (It == 0 || Wall < Result.BestTime)
+      Result.BestTime = Wall;
+    Result.MemUsed = std::max(Result.MemUsed, Time.getMemUsed());
+  }
+  return Result;
+}
+
+
+static double getRate(double Count, double Time)
+{
+  return Time > 0 ? Count / Time : 0;
+}
+
+
+/// Print one benchmark as a JSON object on a line of its own.
+static void printResult(raw_ostream &OS, IRShape Shape, unsigned Size,
+                        BenchPass Kind, const ModuleStats &Stats,
+                        const BenchResult &Result)
+{
+  OS << "{\"label\":";
+  writeQuoted(OS, Label, JSONExport);
+  OS << ",\"shape\":\"" << getShapeName(Shape) << "\""
+     << ",\"size\":" << Size
+     << ",\"pass\":\"" << PassNames[Kind] << "\""
+     << ",\"functions\":" << Stats.Functions
+     << ",\"blocks\":" << Stats.Blocks
+     << ",\"instructions\":" << Stats.Instructions
+     << ",\"edges\":" << Result.Edges
+     << ",\"iterations\":" << unsigned(Iterations)
+     << ",\"best_seconds\":" << format("%.6f", Result.BestTime)
+     << ",\"mean_seconds\":"
+     << format("%.6f", Iterations ? Result.TotalTime / Iterations : 0.0)
+     << ",\"blocks_per_second\":"
+     << format("%.1f", getRate(Stats.Blocks, Result.BestTime))
+     << ",\"edges_per_second\":"
+     << format("%.1f", getRate(Result.Edges, Result.BestTime))
+     << ",\"net_malloc_bytes\":" << int64_t(Result.MemUsed)
+     << ",\"peak_rss_bytes\":" << getPeakMemory()
+     << "}\n";
+}
+
+
+/// Generate a module of the given shape and size; 0 if its IR is invalid.
+static Module *generateModule(const char *Argv0, IRShape Shape,
+                              unsigned Size)
+{
+  IRGenerator Generator(getGlobalContext(), Seed);
+  Generator.setLoopDepth(LoopDepth);
+  OwningPtr<Module> M(Generator.generate(Shape, Size));
+  if (verifyModule(*M, PrintMessageAction))
+  {
+    errs() << Argv0 << ": generated invalid IR for shape '"
+           << getShapeName(Shape) << "'\n";
+    return 0;
+  }
+  return M.take();
+}
+
+
+/*!
+ * Generate a module of the given shape and size, run the analysis Kind on
+ * it and print the record to OS. Return false if the IR is invalid.
+ */
+static bool runRecord(raw_fd_ostream &OS, const char *Argv0, IRShape Shape,
+                      unsigned Size, BenchPass Kind)
+{
+  OwningPtr<Module> M(generateModule(Argv0, Shape, Size));
+  if (!M)
+    return false;
+
+  BenchResult Result = runBenchmark(*M, Kind);
+  printResult(OS, Shape, Size, Kind, countModule(*M), Result);
+  OS.flush();
+  return true;
+}
+
+
+/*!
+ * Run runRecord in a child process where fork() is available, so that the
+ * peak memory it reports is not that of the benchmarks before it.
+ */
+static bool runIsolatedRecord(raw_fd_ostream &OS, const char *Argv0,
+                              IRShape Shape, unsigned Size, BenchPass Kind)
+{
+#ifdef COT_BENCH_FORK
+  OS.flush();
+  pid_t Child = fork();
+  if (Child == 0)
+    _exit(runRecord(OS, Argv0, Shape, Size, Kind) ? 0 : 1);
+  if (Child > 0)
+  {
+    int Status;
+    if (waitpid(Child, &Status, 0) != Child)
+      return false;
+    return WIFEXITED(Status) && WEXITSTATUS(Status) == 0;
+  }
+#endif
+  return runRecord(OS, Argv0, Shape, Size, Kind);
+}
+
+
+int main(int argc, char **argv)
+{
+  sys::PrintStackTraceOnErrorSignal();
+  PrettyStackTraceProgram X(argc, argv);
+  llvm_shutdown_obj Y;
+
+  PassRegistry &Registry = *PassRegistry::getPassRegistry();
+  initializeCore(Registry);
+  initializeAnalysis(Registry);
+  initializeControlDependencyGraphPass(Registry);
+  initializeDataDependencyGraphPass(Registry);
+  initializeProgramDependencyGraphPass(Registry);
+  initializeDependencyLayersPass(Registry);
+  initializePostDominanceFrontierPass(Registry);
+
+  cl::ParseCommandLineOptions(argc, argv,
+                              "dependency graph construction benchmarks\n");
+
+  if (Shapes.empty())
+    for (unsigned S = 0; S != NumIRShapes; ++S)
+      Shapes.push_back(static_cast<IRShape>(S));
+  if (Sizes.empty())
+    Sizes.push_back(256);
+  if (Passes.empty())
+    for (unsigned P = 0; P != NumBenchPasses; ++P)
+      Passes.push_back(static_cast<BenchPass>(P));
+  if (!Iterations)
+    Iterations = 1;
+
+  std::string ErrorInfo;
+  raw_fd_ostream Out(OutputFilename.c_str(), ErrorInfo);
+  if (!ErrorInfo.empty())
+  {
+    errs() << argv[0] << ": " << ErrorInfo << "\n";
+    return 1;
+  }
+
+  for (unsigned S = 0, SE = Shapes.size(); S != SE; ++S)
+    for (unsigned Z = 0, ZE = Sizes.size(); Z != ZE; ++Z)
+    {
+      if (EmitIR)
+      {
+        OwningPtr<Module> M(generateModule(argv[0], Shapes[S], Sizes[Z]));
+        if (!M)
+          return 1;
+        M->print(Out, 0);
+        continue;
+      }
+
+      for (unsigned P = 0, PE = Passes.size(); P != PE; ++P)
+        if (!runIsolatedRecord(Out, argv[0], Shapes[S], Sizes[Z], Passes[P]))
+          return 1;
+    }
+
+  return 0;
+}